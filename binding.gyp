@@ -20,6 +20,7 @@
                 "./src/api/metrics.cc",
                 "./src/api/string_case.cc",
                 "./src/api/array_join.cc",
+                "./src/isolate_data.cc",
                 "./src/iast.cc"
             ],
             "include_dirs" : [
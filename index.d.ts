@@ -20,28 +20,87 @@ declare module 'datadog-iast-taint-tracking' {
         readonly ref?: string;
     }
 
+    // ranges holds (start, end, secureMarks, index in inputInfos) for every range.
+    export interface PackedRanges {
+        ranges: Uint32Array;
+        inputInfos: NativeInputInfo[];
+    }
+
+    // Lookups of the filter in front of the tainted map.
+    export interface TaintFilterStats {
+        negatives: number;
+        positives: number;
+        falsePositives: number;
+        sizeBytes: number;
+    }
+
     export interface Metrics {
         requestCount: number;
+        droppedTaints: number;
+        // Only with DEBUG verbosity.
+        taintFilter?: TaintFilterStats;
     }
 
+    export interface RehashStats {
+        count: number;
+        lastNanos: number;
+        maxNanos: number;
+        totalNanos: number;
+    }
+
+    export interface RehashMetrics {
+        scavenge: RehashStats;
+        markSweepCompact: RehashStats;
+    }
+
+    // What to do with the ranges of a propagation result over the range limit once
+    // adjacent ranges from the same source have been coalesced.
+    export const enum RangeOverflowPolicy {
+        DROP_NEWEST = 0,
+        DROP_OLDEST = 1,
+        MERGE_SOURCES = 2,
+        WIDEN = 3
+    }
+
+    // Opaque object returned by createTransaction when a handle is requested.
+    export interface TransactionHandle {
+        readonly __brand: 'TransactionHandle';
+    }
+
+    export type TransactionId = string | TransactionHandle;
+
     export interface TaintedUtils {
         createTransaction(transactionId: string): string;
-        newTaintedString(transactionId: string, original: string, paramName: string, type: string): string;
-        newTaintedObject(transactionId: string, original: any, paramName: string, type: string): any;
-        addSecureMarksToTaintedString(transactionId: string, taintedString: string, secureMarks: number, createNewTainted?: boolean): string;
-        isTainted(transactionId: string, ...args: string[]): boolean;
-        getMetrics(transactionId: string, telemetryVerbosity: number): Metrics;
-        getRanges(transactionId: string, original: string): NativeTaintedRange[];
-        removeTransaction(transactionId: string): void;
+        createTransaction(transactionId: string, asHandle: true): TransactionHandle;
+        newTaintedString(transactionId: TransactionId, original: string, paramName: string, type: string): string;
+        newTaintedObject(transactionId: TransactionId, original: any, paramName: string, type: string): any;
+        newTaintedObjectDeep(transactionId: TransactionId, obj: object, type: string, maxDepth?: number, maxLeaves?: number): number;
+        addSecureMarksToTaintedString(transactionId: TransactionId, taintedString: string, secureMarks: number, createNewTainted?: boolean): string;
+        isTainted(transactionId: TransactionId, ...args: string[]): boolean;
+        isTaintedBatch(transactionId: TransactionId, values: any[] | object, maxDepth?: number): Uint32Array;
+        isTaintedBatch(transactionId: TransactionId, values: any[] | object, maxDepth: number, asBitmap: true): Uint8Array;
+        getMetrics(transactionId: TransactionId, telemetryVerbosity: number): Metrics;
+        getRehashMetrics(): RehashMetrics | null;
+        getRanges(transactionId: TransactionId, original: string): NativeTaintedRange[];
+        getRangesPacked(transactionId: TransactionId, original: string): PackedRanges | null;
+        removeTransaction(transactionId: TransactionId): void;
         setMaxTransactions(maxTransactions: number): void;
-        concat(transactionId: string, result: string, op1: string, op2: string): string;
-        trim(transactionId: string, result: string, thisArg: string): string;
-        trimEnd(transactionId: string, result: string, thisArg: string): string;
-        slice(transactionId: string, result: string, original: string, start: number, end: number): string;
-        substring(transactionId: string, subject: string, result: string, start: number, end: number): string;
-        substr(transactionId: string, subject: string, result: string, start: number, length: number): string;
-        replace(transactionId: string, result: string, thisArg: string, matcher: unknown, replacer: unknown): string;
-        stringCase(transactionId: string, result: string, thisArg: string): string;
-        arrayJoin(transactionId: string, result: string, thisArg: any[], separator?: any): string;
+        setMaxTaintedObjects(maxTaintedObjects: number): void;
+        setRangeOverflowPolicy(policy: RangeOverflowPolicy): void;
+        concat(transactionId: TransactionId, result: string, op1: string, op2: string): string;
+        concatWithLengths(transactionId: TransactionId, result: string, lengths: Int32Array | Uint32Array | number[], ...operands: any[]): string;
+        concatWithOffsets(transactionId: TransactionId, result: string, operands: any[], offsets?: Int32Array | Uint32Array | number[]): string;
+        trim(transactionId: TransactionId, result: string, thisArg: string): string;
+        trimStart(transactionId: TransactionId, result: string, thisArg: string): string;
+        trimEnd(transactionId: TransactionId, result: string, thisArg: string): string;
+        slice(transactionId: TransactionId, result: string, original: string, start: number, end: number): string;
+        substring(transactionId: TransactionId, subject: string, result: string, start: number, end: number): string;
+        substr(transactionId: TransactionId, subject: string, result: string, start: number, length: number): string;
+        replace(transactionId: TransactionId, result: string, thisArg: string, matcher: unknown, replacer: unknown): string;
+        stringCase(transactionId: TransactionId, result: string, thisArg: string): string;
+        arrayJoin(transactionId: TransactionId, result: string, thisArg: any[], separator?: any): string;
+        // taintedFlag[0] is 1 while any value is tainted, callers can skip the propagation
+        // methods otherwise.
+        readonly taintedFlag: Uint8Array;
     }
 }
@@ -19,31 +19,60 @@ try {
     newTaintedObject (transactionId, original) {
       return original
     },
+    newTaintedObjectDeep () {
+      return 0
+    },
     addSecureMarksToTaintedString (transactionId, original) {
       return original
     },
     isTainted () {
       return false
     },
+    isTaintedBatch (transactionId, values, maxDepth, asBitmap) {
+      if (asBitmap) {
+        const length = Array.isArray(values) ? values.length : Object.keys(values || {}).length
+        return new Uint8Array(Math.ceil(length / 8))
+      }
+      return new Uint32Array(0)
+    },
     getMetrics () {
       return undefined
     },
+    getRehashMetrics () {
+      return null
+    },
     getRanges () {
       return undefined
     },
+    getRangesPacked () {
+      return null
+    },
     removeTransaction () {
     },
     setMaxTransactions () {
     },
+    setMaxTaintedObjects () {
+    },
+    setRangeOverflowPolicy () {
+    },
     replace (transactionId, result) {
       return result
     },
     concat (transactionId, result) {
       return result
     },
+    concatWithLengths (transactionId, result) {
+      return result
+    },
+    concatWithOffsets (transactionId, result) {
+      return result
+    },
     trim (transaction, result) {
       return result
     },
+    trimStart (transaction, result) {
+      return result
+    },
     trimEnd (transaction, result) {
       return result
     },
@@ -65,25 +94,39 @@ try {
   }
 }
 
+// taintedFlag[0] is set by the addon while any value is tainted. Nothing can be propagated
+// while it is 0, so callers can skip the propagation methods without calling into the addon.
+const taintedFlag = addon.taintedFlag || new Uint8Array(1)
+
 const iastNativeMethods = {
   newTaintedString: addon.newTaintedString,
   newTaintedObject: addon.newTaintedObject,
+  newTaintedObjectDeep: addon.newTaintedObjectDeep,
   addSecureMarksToTaintedString: addon.addSecureMarksToTaintedString,
   isTainted: addon.isTainted,
+  isTaintedBatch: addon.isTaintedBatch,
   getMetrics: addon.getMetrics,
+  getRehashMetrics: addon.getRehashMetrics,
   getRanges: addon.getRanges,
+  getRangesPacked: addon.getRangesPacked,
   createTransaction: addon.createTransaction,
   removeTransaction: addon.removeTransaction,
   setMaxTransactions: addon.setMaxTransactions,
-  replace: require('./replace.js')(addon),
+  setMaxTaintedObjects: addon.setMaxTaintedObjects,
+  setRangeOverflowPolicy: addon.setRangeOverflowPolicy,
+  replace: require('./replace.js')(addon, taintedFlag),
   concat: addon.concat,
+  concatWithLengths: addon.concatWithLengths,
+  concatWithOffsets: addon.concatWithOffsets,
   trim: addon.trim,
+  trimStart: addon.trimStart,
   trimEnd: addon.trimEnd,
   slice: addon.slice,
   substring: addon.substring,
   substr: addon.substr,
   stringCase: addon.stringCase,
-  arrayJoin: addon.arrayJoin
+  arrayJoin: addon.arrayJoin,
+  taintedFlag
 }
 
 module.exports = iastNativeMethods
@@ -1,6 +1,6 @@
 const isSpecialRegex = /(\$\$)|(\$&)|(\$`)|(\$')|(\$\d)/
 
-function getReplace (addon) {
+function getReplace (addon, taintedFlag) {
   function isSpecialReplacement (replacer) {
     return replacer.indexOf('$') > -1 && !!replacer.match(isSpecialRegex)
   }
@@ -11,6 +11,9 @@ function getReplace (addon) {
     return addon.replace
   }
   return function replace (transactionId, result, thisArg, matcher, replacer) {
+    if (taintedFlag[0] === 0) {
+      return result
+    }
     if (transactionId && typeof thisArg === 'string' && typeof replacer === 'string') {
       if (typeof matcher === 'string') {
         if (shouldBePropagated(transactionId, thisArg, replacer)) {
@@ -15,6 +15,10 @@ while :; do
         TEST_OPTIONS="-ojunit"
         shift
         ;;
+    --benchmark)
+        TEST_BINARY="native_benchmark"
+        shift
+        ;;
     *)
         break
         ;;
@@ -11,6 +11,8 @@
 #include "../tainted/range.h"
 #include "../tainted/string_resource.h"
 #include "../tainted/transaction.h"
+#include "../utils/propagation.h"
+#include "../utils/range_kernels.h"
 #include "../iast.h"
 
 using v8::FunctionCallbackInfo;
@@ -31,25 +33,12 @@ void copyRangesWithOffset(Transaction* transaction,
         SharedRanges* origRanges,
         SharedRanges** destRanges,
         int offset) {
-    if (origRanges != nullptr) {
-        auto end = origRanges->end();
-        for (auto it = origRanges->begin(); it != end; it++) {
-            auto origRange = *it;
-            auto newRange = transaction->GetRange(
-                origRange->start + offset,
-                origRange->end + offset,
-                origRange->inputInfo,
-                origRange->secureMarks);
-
-            if (newRange != nullptr) {
-                if (*destRanges == nullptr) {
-                    *destRanges = transaction->GetSharedVectorRange();
-                }
-                (*destRanges)->PushBack(newRange);
-            } else {
-                break;
-            }
+    if (origRanges != nullptr && !origRanges->Empty()) {
+        if (*destRanges == nullptr) {
+            *destRanges = transaction->GetSharedVectorRange();
         }
+        auto count = origRanges->Size();
+        utils::kernels::ShiftRanges(origRanges->begin(), (*destRanges)->Extend(count), count, offset);
     }
 }
 
@@ -69,7 +58,7 @@ SharedRanges* getJoinResultRanges(Isolate* isolate,
         auto maybeItem = arr->Get(context, i);
         if (!maybeItem.IsEmpty()) {
             auto item = maybeItem.ToLocalChecked();
-            auto taintedItem = transaction->FindTaintedObject(utils::GetLocalPointer(item));
+            auto taintedItem = transaction->FindTaintedObject(utils::GetTaintKey(item));
             auto itemRanges = taintedItem ? taintedItem->getRanges() : nullptr;
             copyRangesWithOffset(transaction, itemRanges, &newRanges, offset);
             offset += utils::GetLength(isolate, item);
@@ -97,7 +86,7 @@ void ArrayJoinOperator(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    auto transaction = GetTransaction(utils::GetLocalPointer(args[0]));
+    auto transaction = GetTaintedTransaction(args[0]);
     if (transaction == nullptr) {
         args.GetReturnValue().Set(result);
         return;
@@ -114,7 +103,7 @@ void ArrayJoinOperator(const FunctionCallbackInfo<Value>& args) {
                     auto separatorArg = args[3];
                     auto separatorValue = (*separatorArg);
                     if (!separatorValue->IsUndefined()) {
-                        auto taintedSeparator = transaction->FindTaintedObject(utils::GetLocalPointer(separatorArg));
+                        auto taintedSeparator = transaction->FindTaintedObject(utils::GetTaintKey(separatorArg));
                         separatorRanges = taintedSeparator ? taintedSeparator->getRanges() : nullptr;
                         separatorLength = utils::GetCoercedLength(isolate, separatorArg);
                     }
@@ -123,7 +112,8 @@ void ArrayJoinOperator(const FunctionCallbackInfo<Value>& args) {
 
                 auto newRanges = getJoinResultRanges(isolate, transaction, arr, separatorRanges, separatorLength);
                 if (newRanges != nullptr) {
-                    auto key = utils::GetLocalPointer(result);
+                    utils::CompactRanges(newRanges);
+                    auto key = utils::GetTaintKey(result);
                     transaction->AddTainted(key, newRanges, result);
                     args.GetReturnValue().Set(result);
                     return;
@@ -2,6 +2,7 @@
 * Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
 * This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
 **/
+#include <algorithm>
 #include <new>
 #include <vector>
 #include <memory>
@@ -10,6 +11,9 @@
 #include "../iastlimits.h"
 #include "../tainted/range.h"
 #include "../tainted/transaction.h"
+#include "../utils/propagation.h"
+#include "../utils/range_kernels.h"
+#include "../utils/string_utils.h"
 #include "../iast.h"
 
 using v8::FunctionCallbackInfo;
@@ -22,83 +26,275 @@ using iast::tainted::Range;
 
 namespace iast {
 namespace api {
-void TaintConcatOperator(const FunctionCallbackInfo<Value>& args) {
-    auto isolate = args.GetIsolate();
+namespace {
+// Values precomputed by the caller are read once into a buffer on the stack.
+const int MAX_TYPED_VALUES = 32;
+
+// Lengths or offsets of the operands passed by the caller, in an Int32Array, a Uint32Array
+// or an array of numbers. They are only read when an operand is tainted.
+class CallerValues {
+ public:
+    CallerValues(Isolate* isolate, Local<Value> values, int count)
+        : _isolate(isolate), _values(values), _count(count) {}
+
+    // -1 when the value is missing or not valid.
+    int Get(int index) {
+        if (_typedCount < 0) {
+            readTyped();
+        }
+        if (index < _typedCount) {
+            return _typed[index] >= 0 ? _typed[index] : -1;
+        }
+        Local<Value> value;
+        if (_values->IsArray() &&
+                _values.As<v8::Array>()->Get(_isolate->GetCurrentContext(), index).ToLocal(&value) &&
+                value->IsInt32() && value.As<v8::Int32>()->Value() >= 0) {
+            return value.As<v8::Int32>()->Value();
+        }
+        return -1;
+    }
+
+ private:
+    void readTyped() {
+        _typedCount = 0;
+        if (_values->IsInt32Array() || _values->IsUint32Array()) {
+            auto view = _values.As<v8::TypedArray>();
+            _typedCount = std::min({static_cast<int>(view->Length()), _count, MAX_TYPED_VALUES});
+            view->CopyContents(_typed, _typedCount * sizeof(int32_t));
+        }
+    }
 
-    if (args.Length() < 3) {
+    Isolate* _isolate;
+    Local<Value> _values;
+    int _count;
+    int32_t _typed[MAX_TYPED_VALUES];
+    int _typedCount = -1;
+};
+
+// Offsets of the operands added up from their lengths, only measuring the operands
+// before the one asked for. Offsets must be asked for in increasing order.
+template<typename Length>
+class MeasuredOffsets {
+ public:
+    explicit MeasuredOffsets(Length length) : _length(length) {}
+
+    int At(int index) {
+        for (; _measured < index; _measured++) {
+            _offset += _length(_measured);
+        }
+        return _offset;
+    }
+
+ private:
+    Length _length;
+    int _offset = 0;
+    int _measured = 0;
+};
+
+template<typename Length>
+MeasuredOffsets<Length> MeasureOffsets(Length length) {
+    return MeasuredOffsets<Length>(length);
+}
+
+// Whether the ranges still end within result once moved by offset.
+bool FitsIn(const SharedRanges& ranges, int offset, int resultLength) {
+    for (auto& range : ranges) {
+        if (range.start + offset < 0 || range.end + offset > resultLength) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Appends argRanges moved by offset, clamped to result: offsets given by the caller are
+// not trusted to fall within it.
+void AppendShifted(SharedRanges* ranges, const SharedRanges& argRanges, int offset, int resultLength) {
+    auto count = argRanges.Size();
+    if (!FitsIn(argRanges, offset, resultLength)) {
+        auto size = ranges->Size();
+        auto copied = utils::kernels::SliceRanges(argRanges.begin(), ranges->Extend(count), count,
+                -offset, resultLength - offset);
+        ranges->Truncate(size + copied);
+    } else if (offset != 0) {
+        utils::kernels::ShiftRanges(argRanges.begin(), ranges->Extend(count), count, offset);
+    } else {
+        ranges->Append(argRanges);
+    }
+}
+
+// Taints result with the ranges of its count operands, returns false when none of them
+// is tainted or result could not be tainted. operand(i) returns the operand i and
+// offset(i) its position in result, which is only asked for the tainted operands, in
+// increasing order. An untainted concat costs a map lookup per operand.
+template<typename Operand, typename Offset>
+bool PropagateConcat(Transaction* transaction, Local<Value> result, int count, Operand operand, Offset offset) {
+    if (count == 0) {
+        return false;
+    }
+    int resultLength = result.As<v8::String>()->Length();
+    auto taintedObj = transaction->FindTaintedObject(utils::GetTaintKey(operand(0)));
+    auto ranges = taintedObj ? taintedObj->getRanges() : nullptr;
+    bool usingFirstParamRanges = ranges != nullptr;
+    size_t compactFrom = 0;
+    if (ranges != nullptr) {
+        int firstOffset = offset(0);
+        if (firstOffset != 0 || !FitsIn(*ranges, 0, resultLength)) {
+            auto firstRanges = ranges;
+            usingFirstParamRanges = false;
+            ranges = transaction->GetSharedVectorRange();
+            AppendShifted(ranges, *firstRanges, firstOffset, resultLength);
+            compactFrom = ranges->Size();
+        }
+    }
+
+    // Ranges past the limit would be dropped anyway, so the operands are not even looked up.
+    if (ranges == nullptr || ranges->Size() < Limits::MAX_RANGES ||
+            GetRangeOverflowPolicy() != utils::RangeOverflowPolicy::DROP_NEWEST) {
+        for (int i = 1; i < count; i++) {
+            auto taintedObj = transaction->FindTaintedObject(utils::GetTaintKey(operand(i)));
+            auto argRanges = taintedObj ? taintedObj->getRanges() : nullptr;
+            if (argRanges == nullptr) {
+                continue;
+            }
+
+            if (ranges == nullptr) {
+                ranges = transaction->GetSharedVectorRange();
+            } else if (usingFirstParamRanges) {
+                // The new list shares the storage of the first operand and the
+                // ranges of the other operands are appended past its end, so a
+                // chain of concats does not copy the ranges it accumulates.
+                usingFirstParamRanges = false;
+                auto tmpRanges = ranges;
+                ranges = transaction->GetSharedVectorRange();
+                ranges->Append(*tmpRanges);
+                compactFrom = tmpRanges->Size();
+            }
+            AppendShifted(ranges, *argRanges, offset(i), resultLength);
+        }
+    }
+
+    if (ranges == nullptr || ranges->Empty()) {
+        return false;
+    }
+    if (!usingFirstParamRanges) {
+        utils::CompactRanges(ranges, compactFrom);
+    }
+    return transaction->AddTainted(utils::GetTaintKey(result), ranges, result);
+}
+
+bool CheckConcatArguments(const FunctionCallbackInfo<Value>& args, int minLength) {
+    auto isolate = args.GetIsolate();
+    if (args.Length() < minLength) {
         isolate->ThrowException(v8::Exception::TypeError(
                         v8::String::NewFromUtf8(isolate,
                         "Wrong number of arguments",
                         v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    return true;
+}
+}  // namespace
+
+void TaintConcatOperator(const FunctionCallbackInfo<Value>& args) {
+    if (!CheckConcatArguments(args, 3)) {
         return;
     }
+    args.GetReturnValue().Set(args[1]);
     if (!args[1]->IsString()) {
-        args.GetReturnValue().Set(args[1]);
         return;
     }
 
-    auto transaction = GetTransaction(utils::GetLocalPointer(args[0]));
+    auto transaction = GetTaintedTransaction(args[0]);
     if (transaction == nullptr) {
-        args.GetReturnValue().Set(args[1]);
         return;
     }
 
+    auto isolate = args.GetIsolate();
     try {
-        auto argsSize = args.Length();
-        auto taintedObj = transaction->FindTaintedObject(utils::GetLocalPointer(args[2]));
-        auto ranges = taintedObj ? taintedObj->getRanges() : nullptr;
-        bool usingFirstParamRanges = ranges != nullptr;
-
-        if (ranges == nullptr || ranges->Size() < Limits::MAX_RANGES) {
-            int offset = utils::GetCoercedLength(isolate, args[2]);
-            for (int i = 3; i < argsSize; i++) {
-                auto taintedObj = transaction->FindTaintedObject(
-                        utils::GetLocalPointer(args[i]));
-                auto argRanges = taintedObj ? taintedObj->getRanges() : nullptr;
-                if (argRanges != nullptr) {
-                    if (ranges == nullptr) {
-                        ranges = transaction->GetSharedVectorRange();
-                    } else if (usingFirstParamRanges) {
-                        usingFirstParamRanges = false;
-                        auto tmpRanges = ranges;
-                        ranges = transaction->GetSharedVectorRange();
-                        ranges->Add(tmpRanges);
-                    }
-                    auto end = argRanges->end();
-                    if (offset != 0) {
-                        for (auto it = argRanges->begin(); it != end; it++) {
-                            auto argRange = *it;
-                            auto newRange = transaction->GetRange(offset + argRange->start
-                                    , offset + argRange->end,
-                                    argRange->inputInfo, argRange->secureMarks);
-                            ranges->PushBack(newRange);
-                        }
-                    } else {
-                        for (auto it = argRanges->begin(); it != end; it++) {
-                            auto argRange = *it;
-                            ranges->PushBack(argRange);
-                        }
-                    }
-                }
-                offset += utils::GetCoercedLength(isolate, args[i]);
-            }
-        }
+        auto offsets = MeasureOffsets([&](int i) { return utils::GetCoercedLength(isolate, args[i + 2]); });
+        PropagateConcat(transaction, args[1], args.Length() - 2,
+                [&](int i) { return args[i + 2]; },
+                [&](int i) { return offsets.At(i); });
+    } catch (const std::bad_alloc& err) {
+    } catch (const container::QueuedPoolBadAlloc& err) {
+    } catch (const container::PoolBadAlloc& err) {
+    }
+}
 
-        if (ranges != nullptr) {
-            auto key = utils::GetLocalPointer(args[1]);
-            transaction->AddTainted(key, ranges, args[1]);
-            args.GetReturnValue().Set(args[1]);
-            return;
-        }
+// concatWithLengths(transactionId, result, lengths, ...operands), for callers that already
+// know the length of every operand, so non-string operands are never converted.
+void TaintConcatWithLengthsOperator(const FunctionCallbackInfo<Value>& args) {
+    if (!CheckConcatArguments(args, 4)) {
+        return;
+    }
+    args.GetReturnValue().Set(args[1]);
+    if (!args[1]->IsString()) {
+        return;
+    }
+
+    auto transaction = GetTaintedTransaction(args[0]);
+    if (transaction == nullptr) {
+        return;
+    }
+
+    auto isolate = args.GetIsolate();
+    int count = args.Length() - 3;
+    CallerValues lengths(isolate, args[2], count);
+    try {
+        auto offsets = MeasureOffsets([&](int i) {
+            auto length = lengths.Get(i);
+            return length >= 0 ? length : utils::GetCoercedLength(isolate, args[i + 3]);
+        });
+        PropagateConcat(transaction, args[1], count,
+                [&](int i) { return args[i + 3]; },
+                [&](int i) { return offsets.At(i); });
     } catch (const std::bad_alloc& err) {
     } catch (const container::QueuedPoolBadAlloc& err) {
     } catch (const container::PoolBadAlloc& err) {
     }
+}
+
+// concatWithOffsets(transactionId, result, operands, offsets), with the operands in an array
+// and, optionally, the position of each one in result. Missing offsets are measured.
+void TaintConcatWithOffsetsOperator(const FunctionCallbackInfo<Value>& args) {
+    if (!CheckConcatArguments(args, 3)) {
+        return;
+    }
     args.GetReturnValue().Set(args[1]);
+    if (!args[1]->IsString() || !args[2]->IsArray()) {
+        return;
+    }
+
+    auto transaction = GetTaintedTransaction(args[0]);
+    if (transaction == nullptr) {
+        return;
+    }
+
+    auto isolate = args.GetIsolate();
+    auto context = isolate->GetCurrentContext();
+    auto operands = args[2].As<v8::Array>();
+    int count = operands->Length();
+    CallerValues offsets(isolate, args.Length() > 3 ? args[3] : v8::Undefined(isolate).As<Value>(), count);
+    try {
+        auto operand = [&](int i) {
+            Local<Value> value;
+            return operands->Get(context, i).ToLocal(&value) ? value : v8::Undefined(isolate).As<Value>();
+        };
+        auto measured = MeasureOffsets([&](int i) { return utils::GetCoercedLength(isolate, operand(i)); });
+        PropagateConcat(transaction, args[1], count, operand, [&](int i) {
+            auto offset = offsets.Get(i);
+            return offset >= 0 ? offset : measured.At(i);
+        });
+    } catch (const std::bad_alloc& err) {
+    } catch (const container::QueuedPoolBadAlloc& err) {
+    } catch (const container::PoolBadAlloc& err) {
+    }
 }
 
 void ConcatOperations::Init(Local<Object> exports) {
     NODE_SET_METHOD(exports, "concat", TaintConcatOperator);
+    NODE_SET_METHOD(exports, "concatWithLengths", TaintConcatWithLengthsOperator);
+    NODE_SET_METHOD(exports, "concatWithOffsets", TaintConcatWithOffsetsOperator);
 }
 }   // namespace api
 }   // namespace iast
@@ -7,6 +7,7 @@
 #include "metrics.h"
 
 #include "../iast.h"
+#include "../gc/gc.h"
 #include "../utils/string_utils.h"
 #include "../utils/jsobject_utils.h"
 
@@ -22,6 +23,21 @@ using v8::Number;
 namespace iast {
 namespace api {
 
+// Counters of the filter in front of the tainted map, to tune its size.
+Local<Object> GetJsFilterStats(v8::Isolate* isolate, Local<v8::Context> context, Transaction* transaction) {
+    auto& stats = transaction->GetFilterStats();
+    auto jsStats = Object::New(isolate);
+    jsStats->Set(context, utils::NewV8String(isolate, "negatives"),
+            Number::New(isolate, stats.negatives)).Check();
+    jsStats->Set(context, utils::NewV8String(isolate, "positives"),
+            Number::New(isolate, stats.positives)).Check();
+    jsStats->Set(context, utils::NewV8String(isolate, "falsePositives"),
+            Number::New(isolate, stats.falsePositives)).Check();
+    jsStats->Set(context, utils::NewV8String(isolate, "sizeBytes"),
+            Number::New(isolate, transaction->GetFilterSizeBytes())).Check();
+    return jsStats;
+}
+
 void GetMetrics(const FunctionCallbackInfo<Value>& args) {
     auto argsLength = args.Length();
     auto isolate = args.GetIsolate();
@@ -41,8 +57,7 @@ void GetMetrics(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    uintptr_t transactionId = utils::GetLocalPointer(args[0]);
-    auto transaction = GetTransaction(transactionId);
+    auto transaction = GetTransaction(args[0]);
     if (!transaction) {
         args.GetReturnValue().SetNull();
         return;
@@ -50,13 +65,24 @@ void GetMetrics(const FunctionCallbackInfo<Value>& args) {
 
     auto context = isolate->GetCurrentContext();
     auto jsMetrics = Object::New(isolate);
-    switch (static_cast<TelemetryVerbosity>(telemetryVerbosity->IntegerValue(context).FromJust())) {
+    auto verbosity = static_cast<TelemetryVerbosity>(telemetryVerbosity->IntegerValue(context).FromJust());
+    switch (verbosity) {
         case TelemetryVerbosity::DEBUG:
         case TelemetryVerbosity::INFORMATION:
             jsMetrics->Set(context,
                     utils::NewV8String(isolate, "requestCount"),
                     Number::New(isolate, transaction->GetTaintedCount()))
             .Check();
+            jsMetrics->Set(context,
+                    utils::NewV8String(isolate, "droppedTaints"),
+                    Number::New(isolate, transaction->GetDroppedTaints()))
+            .Check();
+            if (verbosity == TelemetryVerbosity::DEBUG) {
+                jsMetrics->Set(context,
+                        utils::NewV8String(isolate, "taintFilter"),
+                        GetJsFilterStats(isolate, context, transaction))
+                .Check();
+            }
 
             args.GetReturnValue().Set(jsMetrics);
             break;
@@ -66,8 +92,33 @@ void GetMetrics(const FunctionCallbackInfo<Value>& args) {
     }
 }
 
+Local<Object> GetJsRehashStats(v8::Isolate* isolate, Local<v8::Context> context, const gc::RehashStats& stats) {
+    auto jsStats = Object::New(isolate);
+    jsStats->Set(context, utils::NewV8String(isolate, "count"),
+            Number::New(isolate, stats.count)).Check();
+    jsStats->Set(context, utils::NewV8String(isolate, "lastNanos"),
+            Number::New(isolate, stats.lastNanos)).Check();
+    jsStats->Set(context, utils::NewV8String(isolate, "maxNanos"),
+            Number::New(isolate, stats.maxNanos)).Check();
+    jsStats->Set(context, utils::NewV8String(isolate, "totalNanos"),
+            Number::New(isolate, stats.totalNanos)).Check();
+    return jsStats;
+}
+
+void GetRehashMetrics(const FunctionCallbackInfo<Value>& args) {
+    auto isolate = args.GetIsolate();
+    auto context = isolate->GetCurrentContext();
+    auto jsMetrics = Object::New(isolate);
+    jsMetrics->Set(context, utils::NewV8String(isolate, "scavenge"),
+            GetJsRehashStats(isolate, context, gc::GetScavengeRehashStats())).Check();
+    jsMetrics->Set(context, utils::NewV8String(isolate, "markSweepCompact"),
+            GetJsRehashStats(isolate, context, gc::GetMarkSweepCompactRehashStats())).Check();
+    args.GetReturnValue().Set(jsMetrics);
+}
+
 void Metrics::Init(Local<Object> exports) {
     NODE_SET_METHOD(exports, "getMetrics", GetMetrics);
+    NODE_SET_METHOD(exports, "getRehashMetrics", GetRehashMetrics);
 }
 }   // namespace api
 }   // namespace iast
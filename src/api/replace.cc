@@ -11,6 +11,8 @@
 #include "../tainted/string_resource.h"
 #include "../tainted/range.h"
 #include "../tainted/transaction.h"
+#include "../utils/propagation.h"
+#include "../utils/range_kernels.h"
 #include "../iast.h"
 #include "../utils/validation_utils.h"
 #include "v8.h"
@@ -27,7 +29,7 @@ using v8::Integer;
 using v8::Int32;
 
 using iast::tainted::Range;
-using iast::utils::GetLocalPointer;
+using iast::utils::GetTaintKey;
 
 namespace iast {
 namespace api {
@@ -52,14 +54,10 @@ inline void addReplacerRanges(Transaction* transaction,
         SharedRanges* newRanges) {
     if (replacerRanges) {
         if (toReplaceStart == 0) {
-            newRanges->Add(replacerRanges);
+            newRanges->Append(*replacerRanges);
         } else {
-            auto replacerItEnd = replacerRanges->end();
-            for (auto replacerIt = replacerRanges->begin(); replacerItEnd != replacerIt; replacerIt++) {
-                auto range = (*replacerIt);
-                newRanges->PushBack(transaction->GetRange(range->start + toReplaceStart,
-                            range->end + toReplaceStart, range->inputInfo, range->secureMarks));
-            }
+            auto count = replacerRanges->Size();
+            utils::kernels::ShiftRanges(replacerRanges->begin(), newRanges->Extend(count), count, toReplaceStart);
         }
     }
 }
@@ -75,19 +73,19 @@ inline SharedRanges* adjustReplacementRanges(Transaction* transaction,
     int offset = replacementLength - matcherLength;
     auto newRanges = transaction->GetSharedVectorRange();
 
-    std::vector<Range*>::iterator subjectIt;
-    std::vector<Range*>::iterator subjectItEnd;
+    SharedRanges::iterator subjectIt = nullptr;
+    SharedRanges::iterator subjectItEnd = nullptr;
 
     if (subjectRanges) {
         subjectIt = subjectRanges->begin();
         subjectItEnd = subjectRanges->end();
-        while (subjectIt != subjectItEnd && (*subjectIt)->start < toReplaceStart) {
+        while (subjectIt != subjectItEnd && subjectIt->start < toReplaceStart) {
             auto range = (*subjectIt);
-            if (range->end <= toReplaceStart) {
+            if (range.end <= toReplaceStart) {
                 newRanges->PushBack(range);
-            } else if (range->end > toReplaceStart) {
-                newRanges->PushBack(transaction->GetRange(range->start, toReplaceStart,
-                                                          range->inputInfo, range->secureMarks));
+            } else if (range.end > toReplaceStart) {
+                newRanges->PushBack(Range(range.start, toReplaceStart,
+                                          range.inputInfoIndex, range.secureMarks));
                 break;
             }
             ++subjectIt;
@@ -99,17 +97,17 @@ inline SharedRanges* adjustReplacementRanges(Transaction* transaction,
     if (subjectRanges) {
         while (subjectIt != subjectItEnd) {
             auto range = (*subjectIt);
-            if (range->end > toReplaceEnd) {
-                if (range->start <= toReplaceEnd) {
-                    newRanges->PushBack(transaction->GetRange(toReplaceEnd + offset,
-                                range->end + offset,
-                                range->inputInfo, range->secureMarks));
+            if (range.end > toReplaceEnd) {
+                if (range.start <= toReplaceEnd) {
+                    newRanges->PushBack(Range(toReplaceEnd + offset,
+                                range.end + offset,
+                                range.inputInfoIndex, range.secureMarks));
                 } else if (offset == 0) {
                     newRanges->PushBack(range);
                 } else {
-                    newRanges->PushBack(transaction->GetRange(range->start + offset,
-                                range->end + offset,
-                                range->inputInfo, range->secureMarks));
+                    newRanges->PushBack(Range(range.start + offset,
+                                range.end + offset,
+                                range.inputInfoIndex, range.secureMarks));
                 }
             }
             subjectIt++;
@@ -124,8 +122,8 @@ inline SharedRanges* adjustRegexReplacementRanges(Transaction* transaction,
         SharedRanges* replacerRanges,
         const MatcherArguments& args,
         Local<Context> context) {
-    std::vector<Range*>::iterator subjectIt;
-    std::vector<Range*>::iterator subjectItEnd;
+    SharedRanges::iterator subjectIt = nullptr;
+    SharedRanges::iterator subjectItEnd = nullptr;
     auto replacerLen = String::Cast(*(args.replacer))->Length();
     auto jsReplacements = Array::Cast(*args.replacements);
     auto newRanges = transaction->GetSharedVectorRange();
@@ -144,25 +142,25 @@ inline SharedRanges* adjustRegexReplacementRanges(Transaction* transaction,
         struct JsReplacementInfo currentReplacement = {index, matcherLength, replacerLen - matcherLength};
 
         if (subjectRanges) {
-            while (subjectIt != subjectItEnd && (*subjectIt)->start < index) {
+            while (subjectIt != subjectItEnd && subjectIt->start < index) {
                 auto breakLoop = false;
                 auto range = *subjectIt;
-                if (lastEnd < range->end) {
-                    auto start = range->start;
-                    auto end = range->end;
-                    if (lastEnd > range->start) {
+                if (lastEnd < range.end) {
+                    auto start = range.start;
+                    auto end = range.end;
+                    if (lastEnd > range.start) {
                         start = lastEnd;
                     }
                     start += offset;
-                    if (range->end > index) {
+                    if (range.end > index) {
                         breakLoop = true;
                         end = index;
                     }
                     end += offset;
-                    if (start == range->start && end == range->end) {
+                    if (start == range.start && end == range.end) {
                         newRanges->PushBack(range);
                     } else {
-                        newRanges->PushBack(transaction->GetRange(start, end, range->inputInfo, range->secureMarks));
+                        newRanges->PushBack(Range(start, end, range.inputInfoIndex, range.secureMarks));
                     }
                 }
                 if (breakLoop) {
@@ -181,16 +179,16 @@ inline SharedRanges* adjustRegexReplacementRanges(Transaction* transaction,
     if (subjectRanges) {
         while (subjectIt != subjectItEnd) {
             auto range = *subjectIt;
-            if (lastEnd < range->end) {
-                if (lastEnd > range->start) {
-                    newRanges->PushBack(transaction->GetRange(lastEnd + offset, range->end + offset,
-                                range->inputInfo, range->secureMarks));
+            if (lastEnd < range.end) {
+                if (lastEnd > range.start) {
+                    newRanges->PushBack(Range(lastEnd + offset, range.end + offset,
+                                range.inputInfoIndex, range.secureMarks));
                 } else if (offset == 0) {
                     newRanges->PushBack(range);
                 } else {
                     newRanges->PushBack(
-                            transaction->GetRange(range->start + offset, range->end + offset,
-                                range->inputInfo, range->secureMarks));
+                            Range(range.start + offset, range.end + offset,
+                                range.inputInfoIndex, range.secureMarks));
                 }
             }
             ++subjectIt;
@@ -209,7 +207,7 @@ void TaintReplaceStringByStringMethod(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    auto transaction = GetTransaction(GetLocalPointer(args[0]));
+    auto transaction = GetTaintedTransaction(args[0]);
     if (!transaction) {
         args.GetReturnValue().Set(replaceResult);
         return;
@@ -218,8 +216,8 @@ void TaintReplaceStringByStringMethod(const FunctionCallbackInfo<Value>& args) {
     try {
         MatcherArguments methodArguments = {args[1], args[2], args[3], args[4], args[5]};
 
-        auto taintedSubject = transaction->FindTaintedObject(GetLocalPointer(methodArguments.self));
-        auto taintedReplacer = transaction->FindTaintedObject(GetLocalPointer(methodArguments.replacer));
+        auto taintedSubject = transaction->FindTaintedObject(GetTaintKey(methodArguments.self));
+        auto taintedReplacer = transaction->FindTaintedObject(GetTaintKey(methodArguments.replacer));
         auto subjectRanges = (taintedSubject) ? taintedSubject->getRanges() : nullptr;
         auto replacerRanges = (taintedReplacer) ? taintedReplacer->getRanges() : nullptr;
 
@@ -230,13 +228,14 @@ void TaintReplaceStringByStringMethod(const FunctionCallbackInfo<Value>& args) {
 
         auto newRanges = adjustReplacementRanges(transaction, subjectRanges, replacerRanges, methodArguments);
         if (newRanges->Size() > 0) {
+            utils::CompactRanges(newRanges);
             auto isolate = args.GetIsolate();
             auto resultString = replaceResult->ToString(isolate->GetCurrentContext()).ToLocalChecked();
             auto resultLength = resultString->Length();
             if (resultLength == 1) {
                 replaceResult = tainted::NewExternalString(isolate, replaceResult);
             }
-            auto key = GetLocalPointer(replaceResult);
+            auto key = GetTaintKey(replaceResult);
             transaction->AddTainted(key, newRanges, replaceResult);
         }
     } catch (const std::bad_alloc& err) {
@@ -257,7 +256,7 @@ void TaintReplaceStringByStringUsingRegexMethod(const FunctionCallbackInfo<Value
         return;
     }
 
-    auto transaction = GetTransaction(GetLocalPointer(args[0]));
+    auto transaction = GetTaintedTransaction(args[0]);
     if (!transaction) {
         args.GetReturnValue().Set(replaceResult);
         return;
@@ -266,8 +265,8 @@ void TaintReplaceStringByStringUsingRegexMethod(const FunctionCallbackInfo<Value
     try {
         MatcherArguments methodArguments = {args[1], args[2], args[3], args[4], args[5]};
 
-        auto taintedSubject = transaction->FindTaintedObject(GetLocalPointer(methodArguments.self));
-        auto taintedReplacer = transaction->FindTaintedObject(GetLocalPointer(methodArguments.replacer));
+        auto taintedSubject = transaction->FindTaintedObject(GetTaintKey(methodArguments.self));
+        auto taintedReplacer = transaction->FindTaintedObject(GetTaintKey(methodArguments.replacer));
         auto subjectRanges = (taintedSubject) ? taintedSubject->getRanges() : nullptr;
         auto replacerRanges = (taintedReplacer) ? taintedReplacer->getRanges() : nullptr;
 
@@ -283,12 +282,13 @@ void TaintReplaceStringByStringUsingRegexMethod(const FunctionCallbackInfo<Value
                 args.GetIsolate()->GetCurrentContext());
 
         if (newRanges->Size() > 0) {
+            utils::CompactRanges(newRanges);
             auto resultString = replaceResult->ToString(args.GetIsolate()->GetCurrentContext()).ToLocalChecked();
             auto resultLength = resultString->Length();
             if (resultLength == 1) {
                 replaceResult = tainted::NewExternalString(args.GetIsolate(), replaceResult);
             }
-            auto key = utils::GetLocalPointer(replaceResult);
+            auto key = utils::GetTaintKey(replaceResult);
             transaction->AddTainted(key, newRanges, replaceResult);
         }
     } catch (const std::bad_alloc& err) {
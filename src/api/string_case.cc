@@ -42,7 +42,7 @@ void StringCaseOperator(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    auto transaction = GetTransaction(utils::GetLocalPointer(args[0]));
+    auto transaction = GetTaintedTransaction(args[0]);
     if (transaction == nullptr) {
         args.GetReturnValue().Set(args[1]);
         return;
@@ -53,7 +53,7 @@ void StringCaseOperator(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    auto taintedObj = transaction->FindTaintedObject(utils::GetLocalPointer(args[2]));
+    auto taintedObj = transaction->FindTaintedObject(utils::GetTaintKey(args[2]));
     if (!taintedObj) {
         args.GetReturnValue().Set(args[1]);
         return;
@@ -71,7 +71,7 @@ void StringCaseOperator(const FunctionCallbackInfo<Value>& args) {
         if (resultLength == 1) {
             res = tainted::NewExternalString(isolate, res);
         }
-        auto key = utils::GetLocalPointer(res);
+        auto key = utils::GetTaintKey(res);
         transaction->AddTainted(key, ranges, res);
         args.GetReturnValue().Set(res);
         return;
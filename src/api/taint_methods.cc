@@ -3,7 +3,9 @@
 * This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
 **/
 #include <node.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "taint_methods.h"
 #include "../tainted/string_resource.h"
@@ -27,13 +29,201 @@ using v8::Value;
 using v8::Array;
 
 using iast::tainted::InputInfo;
+using iast::tainted::Range;
 using iast::tainted::secure_marks_t;
 
 namespace iast {
 namespace api {
+namespace {
+const int PACKED_RANGE_SIZE = 4;
+// Objects are walked recursively on the native stack, deeper graphs are not looked into.
+const int MAX_BATCH_DEPTH = 32;
+
+bool IsTaintedValue(Transaction* transaction, Local<Value> value) {
+    auto taintedObj = transaction->FindTaintedObject(utils::GetTaintKey(value));
+    return taintedObj && taintedObj->getRanges();
+}
+
+// Calls fn(index, key, member) with the elements of an array or the values of the own
+// enumerable properties of an object, until fn returns false, and returns the number
+// of members. The key is left empty for array elements. Proxies are not walked.
+template<typename F>
+uint32_t ForEachMember(Local<v8::Context> context, Local<Object> object, F fn) {
+    if (object->IsProxy()) {
+        return 0;
+    }
+
+    Local<Array> keys;
+    bool isArray = object->IsArray();
+    uint32_t length;
+    if (isArray) {
+        length = object.As<Array>()->Length();
+    } else {
+        if (!object->GetOwnPropertyNames(context).ToLocal(&keys)) {
+            return 0;
+        }
+        length = keys->Length();
+    }
+
+    for (uint32_t i = 0; i < length; i++) {
+        Local<Value> key;
+        Local<Value> member;
+        bool found;
+        if (isArray) {
+            found = object->Get(context, i).ToLocal(&member);
+        } else {
+            found = keys->Get(context, i).ToLocal(&key) && object->Get(context, key).ToLocal(&member);
+        }
+        if (found && !fn(i, key, member)) {
+            break;
+        }
+    }
+    return length;
+}
+
+// Objects reached more than once (shared or cyclic references) are remembered in walked,
+// mapped to -1 when tainted or to the depth they were walked with, and only walked again
+// when reached with a greater depth.
+bool ContainsTaintedValue(Transaction* transaction, Local<v8::Context> context, Local<v8::Map> walked,
+        Local<Value> value, int depth) {
+    if (IsTaintedValue(transaction, value)) {
+        return true;
+    }
+    if (depth <= 0 || !value->IsObject()) {
+        return false;
+    }
+
+    Local<Value> previous;
+    if (!walked->Get(context, value).ToLocal(&previous)) {
+        return false;
+    }
+    if (previous->IsInt32()) {
+        auto walkedDepth = previous.As<v8::Int32>()->Value();
+        if (walkedDepth < 0 || walkedDepth >= depth) {
+            return walkedDepth < 0;
+        }
+    }
+
+    auto isolate = context->GetIsolate();
+    if (walked->Set(context, value, v8::Integer::New(isolate, depth)).IsEmpty()) {
+        return false;
+    }
+
+    bool tainted = false;
+    ForEachMember(context, value.As<Object>(), [&](uint32_t, Local<Value>, Local<Value> member) {
+        tainted = ContainsTaintedValue(transaction, context, walked, member, depth - 1);
+        return !tainted;
+    });
+    if (tainted) {
+        walked->Set(context, value, v8::Integer::New(isolate, -1)).IsEmpty();
+    }
+    return tainted;
+}
+
+// Strings shorter than 10 characters may be shared by V8 (internalized or cached), so a
+// new one is made to avoid tainting every other use of the same value.
+Local<Value> NewTaintableString(Isolate* isolate, Local<Value> value) {
+    int len = v8::Local<v8::String>::Cast(value)->Length();
+    if (len == 1) {
+        return tainted::NewExternalString(isolate, value);
+    } else if (len < 10) {
+        return tainted::NewStringCopy(isolate, value.As<String>());
+    }
+    return value;
+}
+
+// Taints the whole value as coming from the given source. Returns false when it was
+// already tainted or the tainted map is full. Throws when a pool is exhausted.
+bool TaintValue(Transaction* transaction, Isolate* isolate, Local<Value> value,
+        Local<Value> parameterName, Local<Value> type) {
+    auto valuePointer = utils::GetTaintKey(value);
+    if (transaction->FindTaintedObject(valuePointer)) {
+        return false;
+    }
+
+    auto inputInfo = transaction->createNewInputInfo(parameterName, value, type);
+    auto range = Range(0, utils::GetLength(isolate, value), inputInfo, 0);
+    auto ranges = transaction->GetSharedVectorRange();
+    ranges->PushBack(range);
+    return transaction->AddTainted(valuePointer, ranges, value);
+}
+
+const int DEFAULT_DEEP_TAINT_MAX_DEPTH = 32;
+
+struct DeepTaint {
+    Transaction* transaction;
+    Isolate* isolate;
+    Local<v8::Context> context;
+    Local<Value> type;
+    Local<v8::Set> visited;
+    uint32_t maxLeaves;
+    uint32_t taintedLeaves;
+};
+
+// Taints the string members of object with their property path ("a.b.0") as parameter
+// name and walks the object members down to depth levels. Short strings are replaced
+// in the object by the new tainted string, and are left untainted if the object does
+// not accept the new value.
+void TaintMembers(DeepTaint* deepTaint, Local<Object> object, const std::string& path, int depth) {
+    auto context = deepTaint->context;
+    if (deepTaint->visited->Has(context, object).FromMaybe(true)
+            || deepTaint->visited->Add(context, object).IsEmpty()) {
+        return;
+    }
+
+    ForEachMember(context, object, [&](uint32_t index, Local<Value> key, Local<Value> member) {
+        if (deepTaint->taintedLeaves >= deepTaint->maxLeaves) {
+            return false;
+        }
+        if (!member->IsString() && !(member->IsObject() && depth > 1)) {
+            return true;
+        }
+
+        std::string memberPath = path.empty() ? path : path + ".";
+        if (key.IsEmpty()) {
+            memberPath += std::to_string(index);
+        } else {
+            memberPath += *v8::String::Utf8Value(deepTaint->isolate, key);
+        }
+
+        if (member->IsObject()) {
+            TaintMembers(deepTaint, member.As<Object>(), memberPath, depth - 1);
+            return true;
+        }
+        // members tainted by a previous call keep their value, short ones are not copied again
+        if (v8::Local<v8::String>::Cast(member)->Length() == 0
+                || deepTaint->transaction->FindTaintedObject(utils::GetTaintKey(member))) {
+            return true;
+        }
+
+        auto taintable = NewTaintableString(deepTaint->isolate, member);
+        if (taintable != member) {
+            // writes to frozen objects or without setter are ignored, only reading back tells
+            Local<Value> stored;
+            bool replaced = key.IsEmpty()
+                ? object->Set(context, index, taintable).FromMaybe(false) && object->Get(context, index).ToLocal(&stored)
+                : object->Set(context, key, taintable).FromMaybe(false) && object->Get(context, key).ToLocal(&stored);
+            if (!replaced || stored != taintable) {
+                return true;
+            }
+        }
+
+        auto parameterName = v8::String::NewFromUtf8(deepTaint->isolate, memberPath.c_str(),
+                v8::NewStringType::kNormal, memberPath.length()).ToLocalChecked();
+        if (TaintValue(deepTaint->transaction, deepTaint->isolate, taintable, parameterName, deepTaint->type)) {
+            deepTaint->taintedLeaves++;
+        }
+        return true;
+    });
+}
+}  // namespace
 
 void CreateTransaction(const FunctionCallbackInfo<Value>& args) {
     Isolate* isolate = args.GetIsolate();
+    if (args.Length() > 1 && args[1]->BooleanValue(isolate)) {
+        args.GetReturnValue().Set(NewTransactionHandle(isolate));
+        return;
+    }
     args.GetReturnValue().Set(tainted::NewExternalString(isolate, args[0]));
 }
 
@@ -47,7 +237,7 @@ void NewTaintedString(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    if (!(args[0]->IsString()) || !Local<String>::Cast(args[0])->Length()) {
+    if (!IsValidTransactionId(args[0])) {
         args.GetReturnValue().Set(args[1]);
         return;
     }
@@ -62,45 +252,20 @@ void NewTaintedString(const FunctionCallbackInfo<Value>& args) {
     auto parameterName = args[2];
     auto type = args[3];
 
-    // if string length < 10 then make a new one in order to avoid cache issues.
-    int len =  v8::Local<v8::String>::Cast(args[1])->Length();
-    if (len == 0) {
+    if (v8::Local<v8::String>::Cast(args[1])->Length() == 0) {
         args.GetReturnValue().Set(args[1]);
         return;
-    } else if (len == 1) {
-        parameterValue = tainted::NewExternalString(isolate, args[1]);
-    } else if (len < 10) {
-        v8::String::Utf8Value param1(isolate, args[1]);
-        std::string cppStr(*param1);
-        auto newStr = v8::String::NewFromUtf8(isolate, cppStr.c_str(), v8::NewStringType::kNormal).ToLocalChecked();
-        parameterValue = newStr;
     }
+    parameterValue = NewTaintableString(isolate, parameterValue);
 
     args.GetReturnValue().Set(parameterValue);
 
-    uintptr_t transactionId = utils::GetLocalPointer(transactionIdArgument);
-
     try {
-        auto transaction = NewTransaction(transactionId, transactionIdArgument);
+        auto transaction = NewTransaction(transactionIdArgument);
         if (transaction == nullptr) {
             return;
         }
-        auto taintedObj = transaction->FindTaintedObject(utils::GetLocalPointer(parameterValue));
-        if (taintedObj) {
-            // Object already exist, nothing to do
-            return;
-        }
-
-        InputInfo* inputInfo = transaction->createNewInputInfo(
-                    parameterName, parameterValue, type);
-
-        auto range = transaction->GetRange(0,
-                utils::GetLength(args.GetIsolate(), parameterValue),
-                inputInfo, 0);
-        auto ranges = transaction->GetSharedVectorRange();
-        ranges->PushBack(range);
-        auto valuePointer = utils::GetLocalPointer(parameterValue);
-        transaction->AddTainted(valuePointer, ranges, parameterValue);
+        TaintValue(transaction, isolate, parameterValue, parameterName, type);
     } catch (const std::bad_alloc& err) {
         // TODO(julio): log exception?
     } catch (const container::QueuedPoolBadAlloc& err) {
@@ -120,7 +285,7 @@ void AddSecureMarksToTaintedString(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    if (!(args[0]->IsString()) || !Local<String>::Cast(args[0])->Length()) {
+    if (!IsValidTransactionId(args[0])) {
         // invalid transaction id, return taintedString
         args.GetReturnValue().Set(args[1]);
         return;
@@ -147,13 +312,11 @@ void AddSecureMarksToTaintedString(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    uintptr_t transactionId = utils::GetLocalPointer(transactionIdArgument);
-
-    auto transaction = GetTransaction(transactionId);
+    auto transaction = GetTransaction(transactionIdArgument);
     if (transaction == nullptr) {
         return;
     }
-    auto taintedObj = transaction->FindTaintedObject(utils::GetLocalPointer(taintedString));
+    auto taintedObj = transaction->FindTaintedObject(utils::GetTaintKey(taintedString));
     if (!taintedObj) {
         // It is not a tainted object, do nothing
         return;
@@ -164,20 +327,20 @@ void AddSecureMarksToTaintedString(const FunctionCallbackInfo<Value>& args) {
         if (createNewTainted) {
             for (auto it = oRanges->begin(); it != oRanges->end(); ++it) {
                 auto oRange = *it;
-                auto start = oRange->start;
-                auto end = oRange->end;
-                auto oSecureMarks = oRange->secureMarks;
-                newRanges->PushBack(transaction->GetRange(start, end, oRange->inputInfo, oSecureMarks | secureMarks));
+                auto start = oRange.start;
+                auto end = oRange.end;
+                auto oSecureMarks = oRange.secureMarks;
+                newRanges->PushBack(Range(start, end, oRange.inputInfoIndex, oSecureMarks | secureMarks));
             }
             taintedString = tainted::NewStringInstanceForNewTaintedObject
                     (isolate, v8::Local<v8::String>::Cast(taintedString));
-            transaction->AddTainted(utils::GetLocalPointer(taintedString), newRanges, taintedString);
+            transaction->AddTainted(utils::GetTaintKey(taintedString), newRanges, taintedString);
             args.GetReturnValue().Set(taintedString);
         } else {
-            for (auto it = oRanges->begin(); it != oRanges->end(); ++it) {
-                auto oRange = *it;
-                auto oSecureMarks = oRange->secureMarks;
-                oRange->secureMarks = oSecureMarks | secureMarks;
+            for (size_t i = 0; i < oRanges->Size(); i++) {
+                auto oRange = oRanges->At(i);
+                oRange.secureMarks |= secureMarks;
+                oRanges->Set(i, oRange);
             }
         }
     } catch (const std::bad_alloc& err) {
@@ -197,14 +360,13 @@ void IsTainted(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    uintptr_t transactionId = utils::GetLocalPointer(args[0]);
-    auto transaction = GetTransaction(transactionId);
+    auto transaction = GetTaintedTransaction(args[0]);
     if (!transaction) {
         args.GetReturnValue().Set(false);
         return;
     }
     for (auto i = 1; i < argsLength; i++) {
-        auto taintedObj = transaction->FindTaintedObject(utils::GetLocalPointer(args[i]));
+        auto taintedObj = transaction->FindTaintedObject(utils::GetTaintKey(args[i]));
         if (taintedObj && taintedObj->getRanges()) {
             args.GetReturnValue().Set(true);
             return;
@@ -213,6 +375,68 @@ void IsTainted(const FunctionCallbackInfo<Value>& args) {
     args.GetReturnValue().Set(false);
 }
 
+// Checks every element of an array, or every own property value of an object, in a
+// single call. Members that are objects are walked natively up to maxDepth levels.
+// Returns the indices of the tainted members, or a bitmap (bit i of byte i / 8) when
+// asked to.
+void IsTaintedBatch(const FunctionCallbackInfo<Value>& args) {
+    auto isolate = args.GetIsolate();
+    if (args.Length() < 2) {
+        isolate->ThrowException(v8::Exception::TypeError(
+                        v8::String::NewFromUtf8(isolate,
+                        "Wrong number of arguments",
+                        v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    if (!args[1]->IsObject()) {
+        args.GetReturnValue().SetNull();
+        return;
+    }
+
+    auto context = isolate->GetCurrentContext();
+    int maxDepth = args.Length() > 2 && args[2]->IsNumber() ? args[2]->Int32Value(context).FromJust() : 0;
+    maxDepth = std::min(maxDepth, MAX_BATCH_DEPTH);
+    bool asBitmap = args.Length() > 3 && args[3]->BooleanValue(isolate);
+
+    uint32_t length = 0;
+    std::vector<uint32_t> tainted;
+    auto transaction = GetTaintedTransaction(args[0]);
+    {
+        // members whose getters throw are skipped
+        v8::TryCatch tryCatch(isolate);
+        if (transaction == nullptr) {
+            // nothing is tainted, only the number of members is needed
+            length = ForEachMember(context, args[1].As<Object>(), [](uint32_t, Local<Value>, Local<Value>) {
+                return false;
+            });
+        } else {
+            auto walked = v8::Map::New(isolate);
+            length = ForEachMember(context, args[1].As<Object>(),
+                    [&](uint32_t index, Local<Value>, Local<Value> member) {
+                if (ContainsTaintedValue(transaction, context, walked, member, maxDepth)) {
+                    tainted.push_back(index);
+                }
+                return true;
+            });
+        }
+    }
+
+    if (asBitmap) {
+        auto bitmap = v8::Uint8Array::New(v8::ArrayBuffer::New(isolate, (length + 7) / 8), 0, (length + 7) / 8);
+        auto bits = static_cast<uint8_t*>(bitmap->Buffer()->Data());
+        for (auto index : tainted) {
+            bits[index / 8] |= 1 << (index % 8);
+        }
+        args.GetReturnValue().Set(bitmap);
+    } else {
+        auto indices = v8::Uint32Array::New(v8::ArrayBuffer::New(isolate, tainted.size() * sizeof(uint32_t)),
+                0, tainted.size());
+        std::copy(tainted.begin(), tainted.end(), static_cast<uint32_t*>(indices->Buffer()->Data()));
+        args.GetReturnValue().Set(indices);
+    }
+}
+
 void GetRanges(const FunctionCallbackInfo<Value>& args) {
     Isolate* isolate = args.GetIsolate();
 
@@ -223,17 +447,17 @@ void GetRanges(const FunctionCallbackInfo<Value>& args) {
                 NewStringType::kNormal).ToLocalChecked()));
         return;
     }
-    uintptr_t transactionId = utils::GetLocalPointer(args[0]);
-    auto transaction = GetTransaction(transactionId);
+    auto transaction = GetTransaction(args[0]);
     if (transaction != nullptr) {
-        auto taintedObj = transaction->FindTaintedObject(utils::GetLocalPointer(args[1]));
+        auto taintedObj = transaction->FindTaintedObject(utils::GetTaintKey(args[1]));
         auto ranges = taintedObj ? taintedObj->getRanges() : nullptr;
         if (ranges != nullptr) {
             auto currentContext = isolate->GetCurrentContext();
             auto jsRanges = Array::New(isolate);
             int length = ranges->Size();
             for (int i = 0; i < length; i++) {
-                auto jsRange = ranges->At(i)->toJSObject(isolate);
+                auto range = ranges->At(i);
+                auto jsRange = range.toJSObject(isolate, transaction->GetInputInfo(range.inputInfoIndex));
                 jsRanges->Set(currentContext, i, jsRange).Check();
             }
             args.GetReturnValue().Set(jsRanges);
@@ -243,6 +467,63 @@ void GetRanges(const FunctionCallbackInfo<Value>& args) {
     args.GetReturnValue().SetNull();
 }
 
+// Packs the ranges as (start, end, secureMarks, inputInfo index) quadruplets in a single
+// Uint32Array, with every input info only converted once.
+void GetRangesPacked(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+
+    if (args.Length() != 2) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate,
+                "Wrong number of arguments",
+                NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    args.GetReturnValue().SetNull();
+    auto transaction = GetTransaction(args[0]);
+    if (transaction == nullptr) {
+        return;
+    }
+    auto taintedObj = transaction->FindTaintedObject(utils::GetTaintKey(args[1]));
+    auto ranges = taintedObj ? taintedObj->getRanges() : nullptr;
+    if (ranges == nullptr) {
+        return;
+    }
+
+    auto context = isolate->GetCurrentContext();
+    int length = ranges->Size();
+    auto backingStore = v8::ArrayBuffer::NewBackingStore(isolate, length * PACKED_RANGE_SIZE * sizeof(uint32_t));
+    auto packed = static_cast<uint32_t*>(backingStore->Data());
+    std::vector<tainted::input_info_index_t> inputInfos;
+    auto jsInputInfos = Array::New(isolate);
+    for (int i = 0; i < length; i++) {
+        auto range = ranges->At(i);
+        uint32_t inputInfoIndex = 0;
+        while (inputInfoIndex < inputInfos.size() && inputInfos[inputInfoIndex] != range.inputInfoIndex) {
+            inputInfoIndex++;
+        }
+        if (inputInfoIndex == inputInfos.size()) {
+            inputInfos.push_back(range.inputInfoIndex);
+            jsInputInfos->Set(context, inputInfoIndex,
+                    tainted::GetJsObjectFromInputInfo(isolate, context,
+                        transaction->GetInputInfo(range.inputInfoIndex))).Check();
+        }
+
+        packed[i * PACKED_RANGE_SIZE] = range.start;
+        packed[i * PACKED_RANGE_SIZE + 1] = range.end;
+        packed[i * PACKED_RANGE_SIZE + 2] = range.secureMarks;
+        packed[i * PACKED_RANGE_SIZE + 3] = inputInfoIndex;
+    }
+
+    auto buffer = v8::ArrayBuffer::New(isolate, std::move(backingStore));
+    auto jsPacked = Object::New(isolate);
+    jsPacked->Set(context, utils::NewV8String(isolate, "ranges"),
+            v8::Uint32Array::New(buffer, 0, length * PACKED_RANGE_SIZE)).Check();
+    jsPacked->Set(context, utils::NewV8String(isolate, "inputInfos"), jsInputInfos).Check();
+    args.GetReturnValue().Set(jsPacked);
+}
+
 void DeleteTransaction(const FunctionCallbackInfo<Value>& args) {
     Isolate* isolate = args.GetIsolate();
     if (args.Length() != 1) {
@@ -254,8 +535,7 @@ void DeleteTransaction(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    auto transactionId = utils::GetLocalPointer(args[0]);
-    RemoveTransaction(transactionId);
+    RemoveTransaction(args[0]);
 }
 
 void SetMaxTransactions(const FunctionCallbackInfo<Value>& args) {
@@ -276,6 +556,48 @@ void SetMaxTransactions(const FunctionCallbackInfo<Value>& args) {
     iast::SetMaxTransactions(args[0]->IntegerValue(isolate->GetCurrentContext()).FromJust());
 }
 
+void SetMaxTaintedObjects(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    if (args.Length() != 1) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate,
+                "Wrong number of arguments",
+                NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    if (!args[0]->IsNumber()) {
+        return;
+    }
+
+    auto maxTaintedObjects = args[0]->IntegerValue(isolate->GetCurrentContext()).FromJust();
+    if (maxTaintedObjects < 0) {
+        return;
+    }
+    iast::SetMaxTaintedObjects(maxTaintedObjects);
+}
+
+void SetRangeOverflowPolicy(const FunctionCallbackInfo<Value>& args) {
+    Isolate* isolate = args.GetIsolate();
+    if (args.Length() != 1) {
+        isolate->ThrowException(Exception::TypeError(
+            String::NewFromUtf8(isolate,
+                "Wrong number of arguments",
+                NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    if (!args[0]->IsNumber()) {
+        return;
+    }
+
+    auto policy = args[0]->IntegerValue(isolate->GetCurrentContext()).FromJust();
+    if (policy < 0 || policy >= static_cast<int64_t>(utils::RangeOverflowPolicy::MAX)) {
+        return;
+    }
+    iast::SetRangeOverflowPolicy(static_cast<utils::RangeOverflowPolicy>(policy));
+}
+
 void NewTaintedObject(const FunctionCallbackInfo<Value>& args) {
     auto isolate = args.GetIsolate();
     if (args.Length() < 4) {
@@ -286,7 +608,7 @@ void NewTaintedObject(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    if (!(args[0]->IsString()) || !Local<String>::Cast(args[0])->Length()) {
+    if (!IsValidTransactionId(args[0])) {
         args.GetReturnValue().Set(args[1]);
         return;
     }
@@ -303,30 +625,12 @@ void NewTaintedObject(const FunctionCallbackInfo<Value>& args) {
 
     args.GetReturnValue().Set(parameterValue);
 
-    uintptr_t transactionId = utils::GetLocalPointer(transactionIdArgument);
-
     try {
-        auto transaction = NewTransaction(transactionId, transactionIdArgument);
+        auto transaction = NewTransaction(transactionIdArgument);
         if (transaction == nullptr) {
             return;
         }
-        auto taintedObj = transaction->FindTaintedObject(utils::GetLocalPointer(parameterValue));
-        if (taintedObj) {
-            // Object already exist, nothing to do
-            return;
-        }
-
-        InputInfo* inputInfo = transaction->createNewInputInfo(
-                    parameterName, parameterValue, type);
-
-        auto range = transaction->GetRange(0,
-            utils::GetLength(args.GetIsolate(), parameterValue),
-            inputInfo, 0);
-        auto ranges = transaction->GetSharedVectorRange();
-        ranges->PushBack(range);
-
-        auto valuePointer = utils::GetLocalPointer(parameterValue);
-        transaction->AddTainted(valuePointer, ranges, parameterValue);
+        TaintValue(transaction, isolate, parameterValue, parameterName, type);
     } catch (const std::bad_alloc& err) {
         // TODO(julio): log exception?
     } catch (const container::QueuedPoolBadAlloc& err) {
@@ -336,14 +640,63 @@ void NewTaintedObject(const FunctionCallbackInfo<Value>& args) {
     }
 }
 
+// Taints every string leaf of an object graph (a parsed request body, for instance) in
+// a single call, using the property path as parameter name. Walks maxDepth levels and
+// stops after maxLeaves leaves. Returns the number of leaves tainted.
+void NewTaintedObjectDeep(const FunctionCallbackInfo<Value>& args) {
+    auto isolate = args.GetIsolate();
+    if (args.Length() < 3) {
+        isolate->ThrowException(v8::Exception::TypeError(
+                        v8::String::NewFromUtf8(isolate,
+                        "Wrong number of arguments",
+                        v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    args.GetReturnValue().Set(0);
+    if (!IsValidTransactionId(args[0]) || !args[1]->IsObject()) {
+        return;
+    }
+
+    auto context = isolate->GetCurrentContext();
+    int maxDepth = args.Length() > 3 && args[3]->IsNumber()
+        ? args[3]->Int32Value(context).FromJust() : DEFAULT_DEEP_TAINT_MAX_DEPTH;
+    uint32_t maxLeaves = args.Length() > 4 && args[4]->IsNumber()
+        ? args[4]->Uint32Value(context).FromJust() : UINT32_MAX;
+    if (maxDepth <= 0 || maxLeaves == 0) {
+        return;
+    }
+
+    DeepTaint deepTaint = { nullptr, isolate, context, args[2], v8::Set::New(isolate), maxLeaves, 0 };
+    try {
+        deepTaint.transaction = NewTransaction(args[0]);
+        if (deepTaint.transaction == nullptr) {
+            return;
+        }
+
+        // members whose getters or setters throw are skipped
+        v8::TryCatch tryCatch(isolate);
+        TaintMembers(&deepTaint, args[1].As<Object>(), std::string(), maxDepth);
+    } catch (const std::bad_alloc& err) {
+    } catch (const container::QueuedPoolBadAlloc& err) {
+    } catch (const container::PoolBadAlloc& err) {
+    }
+    args.GetReturnValue().Set(deepTaint.taintedLeaves);
+}
+
 void TaintMethods::Init(Local<Object> exports) {
     NODE_SET_METHOD(exports, "createTransaction", CreateTransaction);
     NODE_SET_METHOD(exports, "newTaintedString", NewTaintedString);
+    NODE_SET_METHOD(exports, "newTaintedObjectDeep", NewTaintedObjectDeep);
     NODE_SET_METHOD(exports, "addSecureMarksToTaintedString", AddSecureMarksToTaintedString);
-    NODE_SET_METHOD(exports, "isTainted", IsTainted);  // TODO(julio): support several objects.
+    NODE_SET_METHOD(exports, "isTainted", IsTainted);
+    NODE_SET_METHOD(exports, "isTaintedBatch", IsTaintedBatch);
     NODE_SET_METHOD(exports, "getRanges", GetRanges);
+    NODE_SET_METHOD(exports, "getRangesPacked", GetRangesPacked);
     NODE_SET_METHOD(exports, "removeTransaction", DeleteTransaction);
     NODE_SET_METHOD(exports, "setMaxTransactions", SetMaxTransactions);
+    NODE_SET_METHOD(exports, "setMaxTaintedObjects", SetMaxTaintedObjects);
+    NODE_SET_METHOD(exports, "setRangeOverflowPolicy", SetRangeOverflowPolicy);
     NODE_SET_METHOD(exports, "newTaintedObject", NewTaintedObject);
 }
 }  // namespace api
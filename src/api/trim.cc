@@ -2,6 +2,7 @@
 * Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
 * This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
 **/
+#include <algorithm>
 #include <new>
 #include <vector>
 #include <memory>
@@ -27,87 +28,47 @@ using iast::tainted::Range;
 namespace iast {
 namespace api {
 
-void TaintTrimOperator(const FunctionCallbackInfo<Value>& args) {
-    auto isolate = args.GetIsolate();
-
-    if (args.Length() < 3) {
-        isolate->ThrowException(v8::Exception::TypeError(
-                        v8::String::NewFromUtf8(isolate,
-                        "Wrong number of arguments",
-                        v8::NewStringType::kNormal).ToLocalChecked()));
-        return;
+namespace {
+// Code units read at a time when looking for the end of the leading whitespace.
+const int TRIM_SCAN_CHUNK = 32;
+
+// WhiteSpace and LineTerminator code points, the ones removed by String.prototype.trim.
+bool IsTrimmable(uint16_t c) {
+    switch (c) {
+        case 0x0009: case 0x000A: case 0x000B: case 0x000C: case 0x000D: case 0x0020:
+        case 0x00A0: case 0x1680: case 0x2028: case 0x2029: case 0x202F: case 0x205F:
+        case 0x3000: case 0xFEFF:
+            return true;
+        default:
+            return c >= 0x2000 && c <= 0x200A;
     }
-    if (!args[1]->IsString()) {
-        args.GetReturnValue().Set(args[1]);
-        return;
-    }
-
-    auto transaction = GetTransaction(utils::GetLocalPointer(args[0]));
-    if (transaction == nullptr) {
-        args.GetReturnValue().Set(args[1]);
-        return;
-    }
-
-    try {
-        auto taintedObj = transaction->FindTaintedObject(utils::GetLocalPointer(args[2]));
-        auto ranges = taintedObj ? taintedObj->getRanges() : nullptr;
-        if (ranges == nullptr) {
-            args.GetReturnValue().Set(args[1]);
-            return;
-        }
-
-        int left = 0;
-        v8::String::Utf8Value selfStr(isolate, args[2]);
-
-        char * selfCh = *selfStr;
-        do {
-            if (!isspace(*selfCh)) {
-                break;
-            }
-            left++;
-        } while (*selfCh++);
-
-        int resultLength = TO_V8STRING(args[1])->Length();
-
-        auto resultRanges = transaction->GetSharedVectorRange();
-        auto end = ranges->end();
-        for (auto it = ranges->begin(); it != end; it++) {
-            auto range = *it;
-            int newRangeEnd = range->end - left;
-            int newRangeStart = range->start - left;
-
-            if (newRangeStart < 0) {
-                newRangeStart = 0;
-            }
-
-            if (newRangeEnd >= 0 && newRangeEnd > resultLength) {
-                newRangeEnd = resultLength;
-            }
+}
 
-            if (newRangeEnd > newRangeStart) {
-                auto newRange = transaction->GetRange(newRangeStart, newRangeEnd, range->inputInfo, range->secureMarks);
-                resultRanges->PushBack(newRange);
+// Counts the leading whitespace of value, up to max code units, copying them to a
+// buffer on the stack instead of converting the whole string.
+int CountLeadingWhitespace(Isolate* isolate, Local<String> value, int max) {
+    uint16_t buffer[TRIM_SCAN_CHUNK];
+    int count = 0;
+    while (count < max) {
+        int chunk = std::min(TRIM_SCAN_CHUNK, max - count);
+        value->Write(isolate, buffer, count, chunk, String::NO_NULL_TERMINATION);
+        for (int i = 0; i < chunk; i++) {
+            if (!IsTrimmable(buffer[i])) {
+                return count + i;
             }
         }
-
-        if (resultRanges->Size() > 0) {
-            auto res = args[1];
-            if (resultLength == 1) {
-                res = tainted::NewExternalString(isolate, res);
-            }
-            auto key = utils::GetLocalPointer(res);
-            transaction->AddTainted(key, resultRanges, res);
-            args.GetReturnValue().Set(res);
-            return;
-        }
-    } catch (const std::bad_alloc& err) {
-    } catch (const container::QueuedPoolBadAlloc& err) {
-    } catch (const container::PoolBadAlloc& err) {
+        count += chunk;
     }
-    args.GetReturnValue().Set(args[1]);
+    return count;
 }
 
-void TaintTrimEndOperator(const FunctionCallbackInfo<Value>& args) {
+enum class TrimSide {
+    BOTH,
+    START,
+    END
+};
+
+void TaintTrim(const FunctionCallbackInfo<Value>& args, TrimSide side) {
     auto isolate = args.GetIsolate();
 
     if (args.Length() < 3) {
@@ -122,35 +83,48 @@ void TaintTrimEndOperator(const FunctionCallbackInfo<Value>& args) {
         return;
     }
 
-    auto transaction = GetTransaction(utils::GetLocalPointer(args[0]));
+    auto transaction = GetTaintedTransaction(args[0]);
     if (transaction == nullptr) {
         args.GetReturnValue().Set(args[1]);
         return;
     }
 
     try {
-        auto taintedObj = transaction->FindTaintedObject(utils::GetLocalPointer(args[2]));
+        auto taintedObj = transaction->FindTaintedObject(utils::GetTaintKey(args[2]));
         auto ranges = taintedObj ? taintedObj->getRanges() : nullptr;
-        if (ranges == nullptr) {
+        Local<String> subject;
+        if (ranges == nullptr || !args[2]->ToString(isolate->GetCurrentContext()).ToLocal(&subject)) {
             args.GetReturnValue().Set(args[1]);
             return;
         }
 
+        // Whatever was removed from the subject came from its start, its end or both.
         int resultLength = TO_V8STRING(args[1])->Length();
+        int trimmed = subject->Length() - resultLength;
+        int left = 0;
+        if (side == TrimSide::START) {
+            left = trimmed;
+        } else if (side == TrimSide::BOTH && trimmed > 0) {
+            left = CountLeadingWhitespace(isolate, subject, trimmed);
+        }
 
         auto resultRanges = transaction->GetSharedVectorRange();
         auto end = ranges->end();
         for (auto it = ranges->begin(); it != end; it++) {
             auto range = *it;
-            int newRangeEnd = range->end;
-            int newRangeStart = range->start;
+            int newRangeEnd = range.end - left;
+            int newRangeStart = range.start - left;
+
+            if (newRangeStart < 0) {
+                newRangeStart = 0;
+            }
 
             if (newRangeEnd > resultLength) {
                 newRangeEnd = resultLength;
             }
 
             if (newRangeEnd > newRangeStart) {
-                auto newRange = transaction->GetRange(newRangeStart, newRangeEnd, range->inputInfo, range->secureMarks);
+                auto newRange = Range(newRangeStart, newRangeEnd, range.inputInfoIndex, range.secureMarks);
                 resultRanges->PushBack(newRange);
             }
         }
@@ -160,7 +134,7 @@ void TaintTrimEndOperator(const FunctionCallbackInfo<Value>& args) {
             if (resultLength == 1) {
                 res = tainted::NewExternalString(isolate, res);
             }
-            auto key = utils::GetLocalPointer(res);
+            auto key = utils::GetTaintKey(res);
             transaction->AddTainted(key, resultRanges, res);
             args.GetReturnValue().Set(res);
             return;
@@ -171,9 +145,23 @@ void TaintTrimEndOperator(const FunctionCallbackInfo<Value>& args) {
     }
     args.GetReturnValue().Set(args[1]);
 }
+}  // namespace
+
+void TaintTrimOperator(const FunctionCallbackInfo<Value>& args) {
+    TaintTrim(args, TrimSide::BOTH);
+}
+
+void TaintTrimStartOperator(const FunctionCallbackInfo<Value>& args) {
+    TaintTrim(args, TrimSide::START);
+}
+
+void TaintTrimEndOperator(const FunctionCallbackInfo<Value>& args) {
+    TaintTrim(args, TrimSide::END);
+}
 
 void TrimOperations::Init(Local<Object> exports) {
     NODE_SET_METHOD(exports, "trim", TaintTrimOperator);
+    NODE_SET_METHOD(exports, "trimStart", TaintTrimStartOperator);
     NODE_SET_METHOD(exports, "trimEnd", TaintTrimEndOperator);
 }
 }   // namespace api
@@ -0,0 +1,102 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#ifndef SRC_CONTAINER_BLOOM_FILTER_H_
+#define SRC_CONTAINER_BLOOM_FILTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace iast {
+namespace container {
+
+// Register-blocked Bloom filter over integral keys (pointers). Every key sets HASHES bits
+// of a single 64 bit word, so a query reads one word: a clear bit means the key was never
+// added, all of them set means it may have been. Keys cannot be removed, the filter is
+// cleared and filled again instead.
+//
+// The filter is sized for a number of keys with BitsPerKey bits each; going over that
+// number only raises the false positive rate.
+template<size_t BitsPerKey>
+class BloomFilter {
+    static_assert(BitsPerKey > 0, "at least one bit per key");
+
+ public:
+    static const unsigned HASHES = 3;
+    static const size_t MIN_WORDS = 8;
+
+    explicit BloomFilter(size_t keys = 0) {
+        Reset(keys);
+    }
+
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator =(const BloomFilter&) = delete;
+
+    // Replaces the filter with an empty one sized for keys keys. The filter is left
+    // untouched when the allocation fails.
+    void Reset(size_t keys) {
+        size_t words = MIN_WORDS;
+        while (words * 64 < keys * BitsPerKey) {
+            words <<= 1;
+        }
+        _words.reset(new uint64_t[words]());
+        _mask = words - 1;
+        _keys = keys;
+    }
+
+    void Clear() noexcept {
+        memset(_words.get(), 0, (_mask + 1) * sizeof(uint64_t));
+    }
+
+    void Add(uintptr_t key) noexcept {
+        auto hash = mix(key);
+        _words[index(hash)] |= bits(hash);
+    }
+
+    bool MayContain(uintptr_t key) const noexcept {
+        auto hash = mix(key);
+        auto keyBits = bits(hash);
+        return (_words[index(hash)] & keyBits) == keyBits;
+    }
+
+    // Number of keys the filter was sized for.
+    size_t GetCapacity() const noexcept { return _keys; }
+
+    size_t GetSizeBytes() const noexcept { return (_mask + 1) * sizeof(uint64_t); }
+
+ private:
+    std::unique_ptr<uint64_t[]> _words;
+    size_t _mask = 0;
+    size_t _keys = 0;
+
+    // MurmurHash3 finalizer: heap addresses share their low and high bits, every bit of
+    // the result depends on all of them.
+    static uint64_t mix(uint64_t key) noexcept {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ull;
+        key ^= key >> 33;
+        return key;
+    }
+
+    // The word comes from the high bits, the bit positions from the low ones.
+    size_t index(uint64_t hash) const noexcept {
+        return static_cast<size_t>(hash >> 32) & _mask;
+    }
+
+    static uint64_t bits(uint64_t hash) noexcept {
+        uint64_t result = 0;
+        for (unsigned i = 0; i < HASHES; i++) {
+            result |= 1ull << ((hash >> (6 * i)) & 63);
+        }
+        return result;
+    }
+};
+
+}  // namespace container
+}  // namespace iast
+#endif  // SRC_CONTAINER_BLOOM_FILTER_H_
@@ -0,0 +1,185 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#ifndef SRC_CONTAINER_FLAT_MAP_H_
+#define SRC_CONTAINER_FLAT_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace iast {
+namespace container {
+
+// Open addressing map for integral keys (pointers, ids) using Robin Hood linear
+// probing. Keys and values are stored inline in a single array, so a lookup walks
+// consecutive slots instead of following tree or list nodes. The table doubles when
+// it goes over 3/4 of its slots and removals use backward shift, leaving no tombstones.
+template<typename K, typename V>
+class FlatMap {
+ public:
+    static const size_t INITIAL_SLOTS = 16;
+
+    FlatMap() {
+        allocate(INITIAL_SLOTS);
+    }
+
+    FlatMap(const FlatMap&) = delete;
+    FlatMap& operator =(const FlatMap&) = delete;
+
+    V* Find(K key) const noexcept {
+        auto slot = slotOf(key);
+        return slot == NOT_FOUND ? nullptr : &_slots[slot].value;
+    }
+
+    // Inserts the key or replaces the value it had.
+    void Insert(K key, V value) {
+        auto found = Find(key);
+        if (found) {
+            *found = value;
+            return;
+        }
+
+        if ((_size + 1) * 4 > (_mask + 1) * 3) {
+            grow();
+        }
+        place(key, value);
+        _size++;
+    }
+
+    bool Erase(K key) noexcept {
+        auto slot = slotOf(key);
+        if (slot == NOT_FOUND) {
+            return false;
+        }
+
+        auto next = (slot + 1) & _mask;
+        while (_slots[next].probes > 1) {
+            _slots[slot] = _slots[next];
+            _slots[slot].probes--;
+            slot = next;
+            next = (next + 1) & _mask;
+        }
+        _slots[slot] = Slot();
+        _size--;
+        return true;
+    }
+
+    // Calls fn(key, value) for every entry. The map must not be modified meanwhile.
+    template<typename F>
+    void ForEach(F fn) const {
+        for (size_t i = 0; i <= _mask; i++) {
+            if (_slots[i].probes) {
+                fn(_slots[i].key, _slots[i].value);
+            }
+        }
+    }
+
+    void Clear() noexcept {
+        if (_size == 0) {
+            return;
+        }
+        for (size_t i = 0; i <= _mask; i++) {
+            _slots[i] = Slot();
+        }
+        _size = 0;
+    }
+
+    size_t Size() const noexcept { return _size; }
+
+    // Slots a lookup of key compares, whether it is found or not.
+    size_t Probes(K key) const noexcept {
+        size_t probes;
+        slotOf(key, &probes);
+        return probes;
+    }
+
+ private:
+    struct Slot {
+        K key = K();
+        V value = V();
+        // Distance to the home slot plus one, 0 for empty slots.
+        uint32_t probes = 0;
+    };
+
+    static const size_t NOT_FOUND = SIZE_MAX;
+
+    std::unique_ptr<Slot[]> _slots;
+    size_t _mask = 0;
+    unsigned _bits = 0;
+    size_t _size = 0;
+
+    // Fibonacci hashing, so keys that only differ in their high bits or share their
+    // alignment still spread over the whole table.
+    size_t home(K key) const noexcept {
+        return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> (64 - _bits));
+    }
+
+    // A miss stops at the first slot whose entry is closer to its home than the probe.
+    size_t slotOf(K key, size_t* compared = nullptr) const noexcept {
+        auto slot = home(key);
+        for (uint32_t probes = 1; ; probes++) {
+            auto& current = _slots[slot];
+            if (current.probes < probes) {
+                if (compared) {
+                    *compared = probes;
+                }
+                return NOT_FOUND;
+            }
+            if (current.key == key) {
+                if (compared) {
+                    *compared = probes;
+                }
+                return slot;
+            }
+            slot = (slot + 1) & _mask;
+        }
+    }
+
+    void allocate(size_t slots) {
+        _slots.reset(new Slot[slots]);
+        _mask = slots - 1;
+        _bits = 0;
+        while ((size_t(1) << _bits) < slots) {
+            _bits++;
+        }
+    }
+
+    void grow() {
+        auto slots = std::move(_slots);
+        auto count = _mask + 1;
+        allocate(count * 2);
+        for (size_t i = 0; i < count; i++) {
+            if (slots[i].probes) {
+                place(slots[i].key, slots[i].value);
+            }
+        }
+    }
+
+    // Richer entries (closer to their home) give up their slot to the one being placed.
+    void place(K key, V value) {
+        Slot entry;
+        entry.key = key;
+        entry.value = value;
+        entry.probes = 1;
+        auto slot = home(key);
+        while (true) {
+            auto& current = _slots[slot];
+            if (current.probes == 0) {
+                current = entry;
+                return;
+            }
+            if (current.probes < entry.probes) {
+                std::swap(current, entry);
+            }
+            entry.probes++;
+            slot = (slot + 1) & _mask;
+        }
+    }
+};
+
+}  // namespace container
+}  // namespace iast
+#endif  // SRC_CONTAINER_FLAT_MAP_H_
@@ -5,12 +5,14 @@
 #ifndef SRC_CONTAINER_POOL_H_
 #define SRC_CONTAINER_POOL_H_
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <iostream>
 #include <memory>
 #include <utility>
+#include <vector>
 
 using std::size_t;
 
@@ -20,73 +22,126 @@ namespace container {
 class PoolBadAlloc : public std::exception {
 };
 
-template<class T, size_t N>
+// Pool of up to N elements, a limit that can be lowered or raised at runtime with
+// SetCapacity. Storage is committed lazily in blocks of B elements, so a pool only
+// pays for the blocks it has actually handed out.
+// Using B == N keeps a single slab for the whole default capacity.
+// Slots are handed out in order up to a high-water mark, so clearing and iterating
+// the pool only visit the slots that have ever been used since the last Clear.
+template<class T, size_t N, size_t B = N>
 class Pool final {
  public:
+    static constexpr size_t BLOCK_SIZE = (B > 0 && B < N) ? B : N;
+
     union Element {
         alignas(T) uint8_t storage[sizeof(T)];
         Element* next;
     };
 
+    // Left uninitialized on purpose: slots are only read below the high-water mark.
+    struct Block {
+        Element elements[BLOCK_SIZE];
+        Element* used[BLOCK_SIZE];
+    };
+
     class iterator {
      public:
         using iterator_category = std::forward_iterator_tag;
         using difference_type   = size_t;
-        using value_type        = Element*;
-        using pointer           = Element**;
-        using reference         = Element&;
+        using value_type        = T*;
+        using pointer           = T**;
+        using reference         = T*&;
 
-        iterator(pointer p, pointer end) : _ptr(p), _end(end) {}
-        T* operator *() const { return reinterpret_cast<T*>(&(*_ptr)->storage); }
-        T* operator ->() { return reinterpret_cast<T*>(&(*_ptr)->storage); }
+        iterator(const Pool* pool, size_t index) : _pool(pool), _index(index) {}
+        T* operator *() const { return current(); }
+        T* operator ->() { return current(); }
         iterator& operator ++() {
-            do {
-                _ptr++;
-            } while ((_ptr < _end) && !*_ptr);
+            _index++;
+            skipUnused();
             return *this;
         }
-        friend bool operator ==(const iterator& a, const iterator& b) { return a._ptr == b._ptr; }
-        friend bool operator !=(const iterator& a, const iterator& b) { return a._ptr != b._ptr; }
+        friend bool operator ==(const iterator& a, const iterator& b) { return a._index == b._index; }
+        friend bool operator !=(const iterator& a, const iterator& b) { return a._index != b._index; }
 
      private:
-        pointer _ptr;
-        pointer _end;
-    };
+        friend class Pool;
 
-    Pool() {
-        for (size_t i = 1; i < N; ++i) {
-            _pool[i - 1].next = &_pool[i];
+        T* current() const {
+            auto element = (_index < _pool->_hwm) ? _pool->usedAt(_index) : nullptr;
+            return element ? reinterpret_cast<T*>(&element->storage) : nullptr;
+        }
+
+        void skipUnused() {
+            while (_index < _pool->_hwm && !_pool->usedAt(_index)) {
+                _index++;
+            }
         }
-        _nextAvail = &_pool[0];
-    }
+
+        const Pool* _pool;
+        size_t _index;
+    };
+
+    Pool() = default;
 
     Pool(const Pool&) = delete;
     Pool(Pool&&) = delete;
-    ~Pool() = default;
 
+    ~Pool() {
+        Clear();
+    }
+
+    // Destroys every element in use and gives back all the blocks but the first one,
+    // leaving the pool with its initial committed footprint.
     void Clear() {
-        for (size_t i = 1; i < N; ++i) {
-            if (_used[i - 1]) {
-                _used[i - 1] = nullptr;
-                auto p = reinterpret_cast<T*>(&_pool[i - 1].storage);
-                p->~T();
+        for (size_t i = 0; i < _hwm; ++i) {
+            auto& used = usedAt(i);
+            if (used) {
+                reinterpret_cast<T*>(&used->storage)->~T();
+                used = nullptr;
             }
-            _pool[i - 1].next = &_pool[i];
         }
-        _used[N - 1] = nullptr;
-        _nextAvail = &_pool[0];
+
+        _hwm = 0;
+        _nextAvail = nullptr;
+        if (_blocks.size() > 1) {
+            _blocks.resize(1);
+            _blocksByAddress.assign(1, _blocks[0].get());
+        }
     }
 
     template<class ...Args>
         T* Pop(Args&& ...args) {
-            auto element = _nextAvail;
-            if (!element) {
-                throw PoolBadAlloc();
+            Element* element;
+            Block* block;
+            if (_nextAvail) {
+                element = _nextAvail;
+                block = findBlock(element);
+                _nextAvail = element->next;
+            } else {
+                if (_hwm >= _capacity) {
+                    throw PoolBadAlloc();
+                }
+                auto index = _hwm / BLOCK_SIZE;
+                if (index == _blocks.size()) {
+                    addBlock();
+                }
+                block = _blocks[index].get();
+                element = &block->elements[_hwm % BLOCK_SIZE];
+                _hwm++;
             }
 
-            _nextAvail = element->next;
-            _used[element - &_pool[0]] = element;
-            return new (reinterpret_cast<Element*>(&element->storage)) T(std::forward<Args>(args)...);
+            auto& used = block->used[element - &block->elements[0]];
+            try {
+                auto item = new (reinterpret_cast<Element*>(&element->storage)) T(std::forward<Args>(args)...);
+                used = element;
+                return item;
+            } catch (...) {
+                // the slot goes back to the free list
+                used = nullptr;
+                element->next = _nextAvail;
+                _nextAvail = element;
+                throw;
+            }
         }
 
     void Push(T* p) noexcept {
@@ -95,26 +150,35 @@ class Pool final {
         }
 
         auto element = reinterpret_cast<Element*>(p);
-        if ((element < &_pool[0] || element > &_pool[N - 1])) {
+        auto block = findBlock(element);
+        if (!block) {
             return;
         }
 
         p->~T();
         element->next = _nextAvail;
         _nextAvail = element;
-        _used[element - &_pool[0]] = nullptr;
+        block->used[element - &block->elements[0]] = nullptr;
     }
 
     iterator begin() {
-        auto first = &_used[0];
-        while (first < &_used[N - 1] && !*first) {
-            first++;
-        }
-        return iterator(first, &_used[N - 1]);
+        iterator it(this, 0);
+        it.skipUnused();
+        return it;
     }
 
     iterator end() {
-        return iterator(&_used[N - 1], &_used[N - 1]); }
+        return iterator(this, _hwm);
+    }
+
+    size_t Capacity() const noexcept { return _capacity; }
+    size_t Committed() const noexcept { return _blocks.size() * BLOCK_SIZE; }
+    size_t HighWaterMark() const noexcept { return _hwm; }
+    size_t ReservedBytes() const noexcept { return (_capacity + BLOCK_SIZE - 1) / BLOCK_SIZE * sizeof(Block); }
+
+    // Elements already handed out are kept when the capacity goes below the high-water mark.
+    void SetCapacity(size_t capacity) noexcept { _capacity = capacity; }
+    size_t CommittedBytes() const noexcept { return _blocks.size() * sizeof(Block); }
 
     Pool& operator =(const Pool&) = delete;
 
@@ -122,18 +186,55 @@ class Pool final {
         if (this == &other)
             return *this;
 
-        _pool = std::move(other._pool);
-        _used = std::move(other._used);
+        Clear();
+        _blocks = std::move(other._blocks);
+        _blocksByAddress = std::move(other._blocksByAddress);
         _nextAvail = other._nextAvail;
+        _hwm = other._hwm;
+        _capacity = other._capacity;
 
         other._nextAvail = nullptr;
+        other._hwm = 0;
         return *this;
     }
 
  private:
-    std::unique_ptr<Element[]> _pool = std::make_unique<Element[]>(N);
-    std::unique_ptr<Element*[]> _used = std::make_unique<Element*[]>(N);
+    std::vector<std::unique_ptr<Block>> _blocks;
+    // The same blocks sorted by address, to find the block of an element.
+    std::vector<Block*> _blocksByAddress;
     Element* _nextAvail = nullptr;
+    size_t _hwm = 0;
+    size_t _capacity = N;
+
+    Element*& usedAt(size_t index) const noexcept {
+        return _blocks[index / BLOCK_SIZE]->used[index % BLOCK_SIZE];
+    }
+
+    void addBlock() {
+        _blocks.push_back(std::unique_ptr<Block>(new Block));
+        auto block = _blocks.back().get();
+        try {
+            _blocksByAddress.insert(std::upper_bound(_blocksByAddress.begin(), _blocksByAddress.end(), block,
+                    [](const Block* a, const Block* b) { return address(a) < address(b); }), block);
+        } catch (...) {
+            _blocks.pop_back();
+            throw;
+        }
+    }
+
+    template<class P>
+    static uintptr_t address(const P* p) noexcept { return reinterpret_cast<uintptr_t>(p); }
+
+    // Binary search of the last block starting at or before the element.
+    Block* findBlock(Element* element) const noexcept {
+        auto it = std::upper_bound(_blocksByAddress.begin(), _blocksByAddress.end(), element,
+                [](const Element* e, const Block* b) { return address(e) < address(&b->elements[0]); });
+        if (it == _blocksByAddress.begin()) {
+            return nullptr;
+        }
+        auto block = *(it - 1);
+        return address(element) <= address(&block->elements[BLOCK_SIZE - 1]) ? block : nullptr;
+    }
 };
 
 }  // namespace container
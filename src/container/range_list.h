@@ -0,0 +1,204 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#ifndef SRC_CONTAINER_RANGE_LIST_H_
+#define SRC_CONTAINER_RANGE_LIST_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace iast {
+namespace container {
+
+// List of the ranges of a tainted value. Most values carry one or two ranges, which are
+// kept inline; longer lists spill to a single heap block holding a small header and the
+// elements. Copies share the heap block until one of them is modified (copy-on-write).
+// Elements past the longest list sharing a block are not seen by any of them, so the
+// list reaching that end appends in place and keeps sharing the block: a chain like
+// a += b; a += c... extends a single block instead of copying it at every step.
+// The reference count is not atomic: lists never leave the thread of their isolate.
+template<class T, size_t N>
+class RangeList {
+    static_assert(std::is_trivially_copyable<T>::value, "elements are copied with memcpy");
+    static_assert(N > 0, "at least one element is kept inline");
+    static_assert(alignof(T) <= alignof(size_t), "elements follow the heap block header");
+
+ public:
+    // Iteration is read-only so it never has to detach shared storage.
+    using iterator = const T*;
+
+    RangeList() noexcept {}
+
+    RangeList(const RangeList& other) noexcept {
+        share(other);
+    }
+
+    RangeList& operator=(const RangeList& other) noexcept {
+        if (this != &other) {
+            release();
+            share(other);
+        }
+        return *this;
+    }
+
+    ~RangeList() {
+        release();
+    }
+
+    size_t Size() const noexcept { return _size; }
+    bool Empty() const noexcept { return _size == 0; }
+
+    T At(size_t index) const noexcept { return data()[index]; }
+
+    // Replaces an element, giving the list its own copy of shared storage first.
+    void Set(size_t index, const T& element) {
+        detach();
+        data()[index] = element;
+    }
+
+    void PushBack(const T& element) {
+        reserve(_size + 1);
+        data()[_size] = element;
+        grow(1);
+    }
+
+    // Appends the elements of other, an empty list shares its storage instead.
+    void Append(const RangeList& other) {
+        if (other._size == 0) {
+            return;
+        }
+        if (_size == 0) {
+            *this = other;
+            return;
+        }
+
+        reserve(_size + other._size);
+        memcpy(data() + _size, other.data(), other._size * sizeof(T));
+        grow(other._size);
+    }
+
+    // Elements for in-place edits, giving the list its own copy of shared storage first.
+    T* MutableData() {
+        detach();
+        return data();
+    }
+
+    void Clear() noexcept {
+        release();
+    }
+
+    // Grows the list by count elements left for the caller to fill, returns the first one.
+    T* Extend(size_t count) {
+        reserve(_size + count);
+        auto first = data() + _size;
+        grow(count);
+        return first;
+    }
+
+    void Truncate(size_t size) noexcept {
+        if (size < _size) {
+            _size = size;
+        }
+    }
+
+    iterator begin() const noexcept { return data(); }
+    iterator end() const noexcept { return data() + _size; }
+
+    bool IsInline() const noexcept { return _heap == nullptr; }
+
+    // Number of lists sharing the storage, inline storage is never shared.
+    size_t GetRefs() const noexcept { return _heap ? _heap->refs : 1; }
+
+ private:
+    struct Header {
+        size_t refs;
+        size_t capacity;
+        // Size of the longest list sharing the block.
+        size_t used;
+
+        T* data() noexcept { return reinterpret_cast<T*>(this + 1); }
+    };
+
+    size_t _size = 0;
+    Header* _heap = nullptr;
+    alignas(T) unsigned char _inline[N * sizeof(T)];
+
+    T* data() noexcept { return _heap ? _heap->data() : reinterpret_cast<T*>(_inline); }
+    const T* data() const noexcept {
+        return _heap ? _heap->data() : reinterpret_cast<const T*>(_inline);
+    }
+
+    size_t capacity() const noexcept { return _heap ? _heap->capacity : N; }
+
+    void share(const RangeList& other) noexcept {
+        _size = other._size;
+        _heap = other._heap;
+        if (_heap) {
+            _heap->refs++;
+        } else {
+            memcpy(_inline, other._inline, _size * sizeof(T));
+        }
+    }
+
+    void release() noexcept {
+        if (_heap && --_heap->refs == 0) {
+            free(_heap);
+        }
+        _heap = nullptr;
+        _size = 0;
+    }
+
+    // Makes room for count elements, the ones past the current size must not be seen by
+    // any other list sharing the storage.
+    void reserve(size_t count) {
+        if (count <= capacity() && (!_heap || _heap->refs == 1 || _heap->used == _size)) {
+            return;
+        }
+
+        auto newCapacity = capacity();
+        while (newCapacity < count) {
+            newCapacity *= 2;
+        }
+        reallocate(newCapacity);
+    }
+
+    // Gives the list its own copy of shared storage before its elements are modified.
+    void detach() {
+        if (_heap && _heap->refs > 1) {
+            reallocate(_heap->capacity);
+        }
+    }
+
+    void reallocate(size_t newCapacity) {
+        auto heap = static_cast<Header*>(malloc(sizeof(Header) + newCapacity * sizeof(T)));
+        if (!heap) {
+            throw std::bad_alloc();
+        }
+        heap->refs = 1;
+        heap->capacity = newCapacity;
+        heap->used = _size;
+        memcpy(heap->data(), data(), _size * sizeof(T));
+
+        auto size = _size;
+        release();
+        _heap = heap;
+        _size = size;
+    }
+
+    // Called once count elements reserved past the end have been written.
+    void grow(size_t count) noexcept {
+        _size += count;
+        if (_heap) {
+            _heap->used = _size;
+        }
+    }
+};
+
+}  // namespace container
+}  // namespace iast
+#endif  // SRC_CONTAINER_RANGE_LIST_H_
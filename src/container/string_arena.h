@@ -0,0 +1,71 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#ifndef SRC_CONTAINER_STRING_ARENA_H_
+#define SRC_CONTAINER_STRING_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace iast {
+namespace container {
+
+// Append-only storage for the UTF-16 code units of short strings. Strings are copied
+// one after the other into chunks of CHUNK_UNITS, and a string longer than a quarter
+// of a chunk gets a chunk of its own. Nothing is released until Clear, which keeps
+// the first chunk so the next round of strings does not allocate.
+class StringArena {
+ public:
+    static const size_t CHUNK_UNITS = 2048;
+
+    StringArena() = default;
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    // Room for length code units, valid until Clear. Throws std::bad_alloc.
+    uint16_t* Allocate(size_t length) {
+        if (length > CHUNK_UNITS / 4) {
+            _chunks.emplace_back(new uint16_t[length]);
+            _committed += length;
+            return _chunks.back().get();
+        }
+        if (length > _free) {
+            if (!_first) {
+                _first.reset(new uint16_t[CHUNK_UNITS]);
+                _next = _first.get();
+            } else {
+                _chunks.emplace_back(new uint16_t[CHUNK_UNITS]);
+                _next = _chunks.back().get();
+            }
+            _committed += CHUNK_UNITS;
+            _free = CHUNK_UNITS;
+        }
+        auto units = _next;
+        _next += length;
+        _free -= length;
+        return units;
+    }
+
+    void Clear() noexcept {
+        _chunks.clear();
+        _next = _first.get();
+        _free = _first ? CHUNK_UNITS : 0;
+        _committed = _free;
+    }
+
+    size_t CommittedBytes() const noexcept { return _committed * sizeof(uint16_t); }
+
+ private:
+    std::unique_ptr<uint16_t[]> _first;
+    std::vector<std::unique_ptr<uint16_t[]>> _chunks;
+    uint16_t* _next = nullptr;
+    size_t _free = 0;
+    size_t _committed = 0;
+};
+
+}  // namespace container
+}  // namespace iast
+#endif  // SRC_CONTAINER_STRING_ARENA_H_
@@ -9,11 +9,11 @@
 #include <stddef.h>
 #include <cstdint>
 #include <iostream>
+#include <memory>
+#include <utility>
 
 #include "../weakiface.h"
 
-#define GET_INDEX(ptr, mask) (ptr >> 3 & (mask))
-
 enum {
     WEAK_MAP_SUCCESS = 0,
     WEAK_MAP_INVALID_ARG,
@@ -23,139 +23,356 @@ enum {
 
 namespace iast {
 namespace container {
+// Open addressing table using Robin Hood linear probing: every slot stores the key and
+// the entry inline, so a lookup compares keys in consecutive slots without touching
+// the entries, and a miss stops as soon as it finds a slot closer to its home than the
+// probe. The table has room for twice the number of entries the map can currently
+// hold, so it never goes above half load.
+//
+// Besides the table, every entry is kept in a compact array so that Clean and Rehash
+// only visit live entries. The array is split in two: entries that have already been
+// seen standing still across scavenges ("old") and the rest ("young"), so a scavenge
+// only needs to look at the young ones.
+//
+// Standing still is not proof of being in the old generation: a young generation that
+// keeps objects in place (page promotion within new space, --minor-ms) can move an old
+// entry in a later scavenge. Find checks that an old entry it hits still resolves to the
+// key, so a value allocated at the previous address is not taken for it.
+//
+// The map starts with room for INITIAL_CAPACITY entries and doubles when it is full,
+// up to a maximum of N entries that can be changed at runtime with SetMaxElements.
 template <typename T, size_t N>
 class WeakMap {
  public:
+    // Consecutive scavenges an entry must survive without moving to be considered old.
+    static const uint8_t PROMOTION_AGE = 2;
+    static constexpr size_t INITIAL_CAPACITY = N < 64 ? N : 64;
+
     WeakMap() {
         this->_count = 0;
+        allocate(INITIAL_CAPACITY);
     }
 
     ~WeakMap() {
-        for (size_t index = 0; index < N; index++) {
-            auto obj = this->items[index];
-            while (obj != nullptr) {
-                auto next = obj->_next;
-                delete obj;
-                obj = next;
-            }
+        for (size_t i = 0; i < _count; i++) {
+            delete _live[i];
         }
     }
 
+    // Every slot in use belongs to a live entry, so wiping the cluster that follows the
+    // home slot of each entry empties the whole table without sweeping it.
+    // A map that had to grow goes back to its initial size.
     void Clean() {
-        // TODO(julio): check memset std::fill for performance.
-        for (size_t i = 0; i < N; i++) {
-            this->items[i] = nullptr;
+        if (_capacity > INITIAL_CAPACITY) {
+            allocate(INITIAL_CAPACITY);
+            _count = 0;
+            _oldCount = 0;
+            return;
+        }
+
+        for (size_t i = 0; i < _count; i++) {
+            for (auto slot = home(_live[i]->_key); _table[slot].key != 0; slot = (slot + 1) & _tableMask) {
+                _table[slot] = Slot();
+            }
         }
         _count = 0;
+        _oldCount = 0;
     }
 
     T Find(weak_key_t key) {
-        T ret = nullptr;
-        auto index = GET_INDEX(key, MASK);
-        auto obj = static_cast<T>(this->items[index]);
-        while (obj != nullptr) {
-            if (obj->_key == key) {
-                ret = obj->IsEmpty() ? nullptr : static_cast<T>(obj);
-                break;
-            } else {
-                obj = static_cast<T>(obj->_next);
-            }
+        size_t slot;
+        if (!lookup(key, &slot)) {
+            return nullptr;
+        }
+        auto obj = _table[slot].obj;
+        if (obj->IsEmpty()) {
+            return nullptr;
         }
-        return ret;
+        if (obj->_index < _oldCount && obj->Get() != key) {
+            rekeyOld(slot);
+            return nullptr;
+        }
+        return obj;
     }
 
-    int Insert(weak_key_t key, T obj) {
-        if (!obj) {
+    // Entries whose key never changes can be inserted as pinned: they go straight to
+    // the old part of the array and are never looked at by a scavenge.
+    // Inserting a key that is already present replaces the previous entry, which is
+    // dropped from the map but not deleted: it is returned through replaced, so the
+    // caller can release it. Replacing an entry does not count against the maximum.
+    int Insert(weak_key_t key, T obj, bool pinned = false, T* replaced = nullptr) {
+        if (replaced) {
+            *replaced = nullptr;
+        }
+        if (!obj || key == 0) {
             return WEAK_MAP_INVALID_ARG;
         }
 
-        // TODO(julio): check policy for insertion:
-        // * If max elements are exhausted then error (current).
-        // * If all buckets are exhausted then error (Likely to be selected).
-        // * Replace old element with the new one.
-        if (_count >= N) {
-            return WEAK_MAP_MAX_ELEM;
+        size_t slot;
+        if (lookup(key, &slot)) {
+            auto previous = _table[slot].obj;
+            removeLive(previous->_index);
+            obj->_key = key;
+            _table[slot].obj = obj;
+            if (replaced) {
+                *replaced = previous;
+            }
+        } else {
+            if (_count >= _maxElements) {
+                return WEAK_MAP_MAX_ELEM;
+            }
+            if (_count >= _capacity) {
+                grow();
+            }
+            obj->_key = key;
+            place(obj);
         }
 
-        auto index = GET_INDEX(key, MASK);
-        auto taintedObjectInArray = this->items[index];
-        if (taintedObjectInArray != nullptr) {
-            obj->_next = taintedObjectInArray;
-        } else {
-            obj->_next = nullptr;
+        addLive(obj);
+        if (pinned) {
+            swapLive(_count - 1, _oldCount);
+            _oldCount++;
         }
-        this->items[index] = obj;
-        _count++;
         return WEAK_MAP_SUCCESS;
     }
 
     void Del(weak_key_t key) {
-        auto index = GET_INDEX(key, MASK);
-        auto root = this->items[index];
-        auto prev = root;
-        if (root->_key == key) {
-            this->items[index] = root->_next;
-            delete root;
-            _count--;
-        } else {
-            for (root = root->_next; root != nullptr; root = root->_next) {
-                if (root->_key == key) {
-                    prev->_next = root->_next;
-                    delete root;
-                    _count--;
-                    break;
-                }
-                prev = root;
-            }
+        size_t slot;
+        if (!lookup(key, &slot)) {
+            return;
         }
+
+        auto obj = _table[slot].obj;
+        erase(slot);
+        removeLive(obj->_index);
+        delete obj;
     }
 
-    void Rehash() {
-        for (size_t index = 0; index < N; index++) {
-            T prev = nullptr;
-            auto obj = static_cast<T>(this->items[index]);
-            while (obj != nullptr) {
-                if (obj->IsEmpty()) {
-                    // removed by GC so prev remains the same
-                    remove(index, prev, obj);
-                    auto toDelete = obj;
-                    obj = static_cast<T>(obj->_next);
-                    toDelete->_next = nullptr;
-                } else {
-                    auto newPointer = obj->Get();
-                    if (newPointer != obj->_key) {
-                        // moved by GC so prev remains the same
-                        remove(index, prev, obj);
-                        auto toInsert = obj;
-                        obj = static_cast<T>(obj->_next);
-
-                        toInsert->_next = nullptr;
-                        toInsert->_key = newPointer;
-                        Insert(newPointer, toInsert);
-                    } else {
-                        prev = obj;
-                        obj = static_cast<T>(obj->_next);
-                    }
-                }
+    // Drops entries released by the GC and moves the ones whose key changed to their
+    // new slot. When onlyYoung is set (after a scavenge) old entries are skipped.
+    // Moved entries are taken out of the table before any of them is placed again,
+    // since a new key may still be held by an entry that has not been visited yet.
+    void Rehash(bool onlyYoung = false) {
+        size_t start = onlyYoung ? _oldCount : 0;
+        size_t i = start;
+        while (i < _count) {
+            auto obj = _live[i];
+            if (obj->IsEmpty()) {
+                // removed by GC, the entry in i is replaced so it is not advanced
+                erase(slotOf(obj));
+                removeLive(i);
+                continue;
+            }
+
+            auto newPointer = obj->Get();
+            if (newPointer != obj->_key) {
+                // moved by GC
+                erase(slotOf(obj));
+                obj->_key = newPointer;
+                _ages[i] = MOVED;
+            } else if (onlyYoung && ++_ages[i] >= PROMOTION_AGE) {
+                swapLive(i, _oldCount);
+                _oldCount++;
+            }
+            i++;
+        }
+
+        for (i = start; i < _count; i++) {
+            if (_ages[i] == MOVED) {
+                place(_live[i]);
+                _ages[i] = 0;
             }
         }
     }
 
+    // Calls fn with the key of every entry, or only of the young ones.
+    template<typename F>
+    void ForEachKey(F fn, bool onlyYoung = false) const {
+        for (size_t i = onlyYoung ? _oldCount : 0; i < _count; i++) {
+            fn(_live[i]->_key);
+        }
+    }
+
+    // Slots a lookup of key compares, whether it is found or not.
+    size_t GetProbes(weak_key_t key) const {
+        size_t slot;
+        size_t probes;
+        lookup(key, &slot, &probes);
+        return probes;
+    }
+
     int GetCount(void) { return _count; }
+    int GetYoungCount(void) { return _count - _oldCount; }
+    size_t GetCapacity(void) { return _capacity; }
+    size_t GetMaxElements(void) { return _maxElements; }
+
+    // Entries already in the map are kept when the maximum goes below the current count,
+    // only new insertions are refused.
+    void SetMaxElements(size_t maxElements) {
+        _maxElements = maxElements;
+    }
 
  private:
-    const int MASK = N - 1;
+    struct Slot {
+        weak_key_t key = 0;
+        T obj = nullptr;
+    };
+
+    static constexpr size_t tableSize(size_t n) {
+        size_t size = 2;
+        while (size < 2 * n) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    static constexpr unsigned bitsFor(size_t n) {
+        return n > 1 ? 1 + bitsFor(n >> 1) : 0;
+    }
+
+    // Marks entries taken out of the table during a rehash, never reached by a real age.
+    static const uint8_t MOVED = UINT8_MAX;
+
     size_t _count;
-    WeakObjIface<T>* items[N] = {};
+    size_t _oldCount = 0;
+    size_t _capacity = 0;
+    size_t _maxElements = N;
+    size_t _tableMask = 0;
+    unsigned _tableBits = 0;
+    std::unique_ptr<Slot[]> _table;
+    std::unique_ptr<T[]> _live;
+    std::unique_ptr<uint8_t[]> _ages;
 
-    void remove(int index, T prev, T obj) {
-        auto next = obj->_next;
-        if (prev == nullptr) {
-            this->items[index] = next;
-        } else {
-            prev->_next = next;
+    // Fibonacci hashing: the multiplication carries the low bits of the key, which are
+    // almost constant for aligned heap addresses, into the top bits used as index.
+    size_t home(weak_key_t key) const {
+        return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> (64 - _tableBits));
+    }
+
+    size_t distance(size_t slot, weak_key_t key) const {
+        return (slot - home(key)) & _tableMask;
+    }
+
+    // Replaces the storage with an empty one for capacity entries.
+    void allocate(size_t capacity) {
+        auto tableSlots = tableSize(capacity);
+        _table.reset(new Slot[tableSlots]);
+        _live.reset(new T[capacity]);
+        _ages.reset(new uint8_t[capacity]);
+        _capacity = capacity;
+        _tableMask = tableSlots - 1;
+        _tableBits = bitsFor(tableSlots);
+    }
+
+    // Doubles the capacity, without going over the maximum, and places every entry again
+    // in the new table. The live array keeps its order so indexes stay valid.
+    void grow() {
+        auto live = std::move(_live);
+        auto ages = std::move(_ages);
+        allocate(_capacity * 2 < _maxElements ? _capacity * 2 : _maxElements);
+        for (size_t i = 0; i < _count; i++) {
+            _live[i] = live[i];
+            _ages[i] = ages[i];
+            place(_live[i]);
+        }
+    }
+
+    bool lookup(weak_key_t key, size_t* found, size_t* probes = nullptr) const {
+        auto slot = home(key);
+        for (size_t dist = 0; ; dist++) {
+            auto slotKey = _table[slot].key;
+            if (slotKey == key) {
+                if (probes) {
+                    *probes = dist + 1;
+                }
+                *found = slot;
+                return key != 0;
+            }
+            if (slotKey == 0 || distance(slot, slotKey) < dist) {
+                if (probes) {
+                    *probes = dist + 1;
+                }
+                return false;
+            }
+            slot = (slot + 1) & _tableMask;
+        }
+    }
+
+    size_t slotOf(T obj) const {
+        auto slot = home(obj->_key);
+        while (_table[slot].obj != obj) {
+            slot = (slot + 1) & _tableMask;
+        }
+        return slot;
+    }
+
+    // Richer entries (closer to their home) give up their slot to the one being placed.
+    void place(T obj) {
+        Slot entry;
+        entry.key = obj->_key;
+        entry.obj = obj;
+        auto slot = home(entry.key);
+        for (size_t dist = 0; ; dist++) {
+            auto& current = _table[slot];
+            if (current.key == 0) {
+                current = entry;
+                return;
+            }
+            auto currentDist = distance(slot, current.key);
+            if (currentDist < dist) {
+                std::swap(current, entry);
+                dist = currentDist;
+            }
+            slot = (slot + 1) & _tableMask;
+        }
+    }
+
+    // Backward shift deletion, so no tombstones are left behind.
+    void erase(size_t slot) {
+        auto next = (slot + 1) & _tableMask;
+        while (_table[next].key != 0 && distance(next, _table[next].key) > 0) {
+            _table[slot] = _table[next];
+            slot = next;
+            next = (next + 1) & _tableMask;
+        }
+        _table[slot] = Slot();
+    }
+
+    void addLive(T obj) {
+        _live[_count] = obj;
+        _ages[_count] = 0;
+        obj->_index = _count;
+        _count++;
+    }
+
+    void swapLive(size_t a, size_t b) {
+        std::swap(_live[a], _live[b]);
+        std::swap(_ages[a], _ages[b]);
+        _live[a]->_index = a;
+        _live[b]->_index = b;
+    }
+
+    // An old entry that moved is placed again under its current key and goes back to the
+    // young part, so the next scavenge looks at it again.
+    void rekeyOld(size_t slot) {
+        auto obj = _table[slot].obj;
+        erase(slot);
+        obj->_key = obj->Get();
+        place(obj);
+        _oldCount--;
+        swapLive(obj->_index, _oldCount);
+        _ages[_oldCount] = 0;
+    }
+
+    // Keeps the array compact and the old entries in front of the young ones.
+    void removeLive(size_t i) {
+        if (i < _oldCount) {
+            _oldCount--;
+            swapLive(i, _oldCount);
+            i = _oldCount;
         }
         _count--;
+        swapLive(i, _count);
     }
 };
 }  // namespace container
@@ -2,22 +2,47 @@
 * Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
 * This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
 **/
+#include <chrono>
+
 #include "gc.h"
 #include "../iast.h"
+#include "../isolate_data.h"
 
 
 namespace iast {
 namespace gc {
+namespace {
+void TimedRehash(RehashStats* stats, bool onlyYoung) {
+    auto start = std::chrono::steady_clock::now();
+    RehashAllTransactions(onlyYoung);
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    stats->count++;
+    stats->lastNanos = elapsed;
+    stats->totalNanos += elapsed;
+    if (elapsed > stats->maxNanos) {
+        stats->maxNanos = elapsed;
+    }
+}
+}  // namespace
 
 void OnMarkSweepCompact(v8::Isolate *isolate, v8::GCType type, v8::GCCallbackFlags flags) {
-    RehashAllTransactions();
+    TimedRehash(&IsolateData::Get()->markSweepCompactStats, false);
 }
 
+// Entries already seen standing still across scavenges are skipped, see WeakMap.
 void OnScavenge(v8::Isolate *isolate, v8::GCType type, v8::GCCallbackFlags flags) {
-    RehashAllTransactions();
+    TimedRehash(&IsolateData::Get()->scavengeStats, true);
 }
 
+const RehashStats& GetScavengeRehashStats(void) {
+    return IsolateData::Get()->scavengeStats;
+}
+
+const RehashStats& GetMarkSweepCompactRehashStats(void) {
+    return IsolateData::Get()->markSweepCompactStats;
+}
 
 }   // namespace gc
 }   // namespace iast
-
@@ -6,11 +6,21 @@
 #define SRC_GC_GC_H_
 
 #include <v8.h>
+#include <cstdint>
 
 namespace iast {
 namespace gc {
+struct RehashStats {
+    uint64_t count = 0;
+    uint64_t lastNanos = 0;
+    uint64_t maxNanos = 0;
+    uint64_t totalNanos = 0;
+};
+
 void OnMarkSweepCompact(v8::Isolate *isolate, v8::GCType type, v8::GCCallbackFlags flags);
 void OnScavenge(v8::Isolate *isolate, v8::GCType type, v8::GCCallbackFlags flags);
+const RehashStats& GetScavengeRehashStats(void);
+const RehashStats& GetMarkSweepCompactRehashStats(void);
 }  // namespace gc
 }  // namespace iast
 #endif  // SRC_GC_GC_H_
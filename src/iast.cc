@@ -7,7 +7,7 @@
 #include <cstddef>
 #include "iast.h"
 #include "gc/gc.h"
-#include "container/singleton.h"
+#include "isolate_data.h"
 #include "transaction_manager.h"
 #include "api/taint_methods.h"
 #include "tainted/transaction.h"
@@ -19,30 +19,129 @@
 #include "api/metrics.h"
 #include "api/string_case.h"
 #include "api/array_join.h"
-
-using transactionManager = iast::container::Singleton<iast::TransactionManager<iast::tainted::Transaction,
-      iast::tainted::transaction_key_t>>;
+#include "utils/jsobject_utils.h"
+#include "utils/string_utils.h"
 
 namespace iast {
+namespace {
+// Handles are instances of a function template of the isolate, which tells them apart
+// from any other object without reading internal fields set by someone else. Their
+// only internal field holds their transaction.
+const int HANDLE_TRANSACTION_FIELD = 0;
+const int HANDLE_FIELD_COUNT = 1;
+
+// Once removed, a transaction can be reused for another id, so the pointer is only
+// trusted while the transaction still references the handle.
+Transaction* GetHandleTransaction(v8::Local<v8::Object> handle) {
+    auto transaction = static_cast<Transaction*>(handle->GetAlignedPointerFromInternalField(HANDLE_TRANSACTION_FIELD));
+    return transaction && transaction->IsReferencedBy(handle) ? transaction : nullptr;
+}
+}  // namespace
 
-void RehashAllTransactions(void) {
-    transactionManager::GetInstance().RehashAll();
+void RehashAllTransactions(bool onlyYoung) {
+    IsolateData::Get()->transactionManager.RehashAll(onlyYoung);
 }
 
 void RemoveTransaction(transaction_key_t id) {
-    transactionManager::GetInstance().Remove(id);
+    IsolateData::Get()->transactionManager.Remove(id);
 }
 
 Transaction* GetTransaction(transaction_key_t id) {
-    return transactionManager::GetInstance().Get(id);
+    return IsolateData::Get()->transactionManager.Get(id);
 }
 
 Transaction* NewTransaction(transaction_key_t id, v8::Local<v8::Value> jsObject) {
-    return transactionManager::GetInstance().New(id, jsObject);
+    auto data = IsolateData::Get();
+    auto transaction = data->transactionManager.New(id, jsObject);
+    if (transaction) {
+        transaction->SetMaxTaintedObjects(data->maxTaintedObjects);
+    }
+    return transaction;
 }
 
 void SetMaxTransactions(size_t maxItems) {
-    transactionManager::GetInstance().setMaxItems(maxItems);
+    IsolateData::Get()->transactionManager.setMaxItems(maxItems);
+}
+
+void SetMaxTaintedObjects(size_t maxItems) {
+    IsolateData::Get()->maxTaintedObjects = maxItems;
+}
+
+void SetRangeOverflowPolicy(utils::RangeOverflowPolicy policy) {
+    IsolateData::Get()->rangeOverflowPolicy = policy;
+}
+
+utils::RangeOverflowPolicy GetRangeOverflowPolicy() {
+    return IsolateData::Get()->rangeOverflowPolicy;
+}
+
+v8::Local<v8::Object> NewTransactionHandle(v8::Isolate* isolate) {
+    auto& handleTemplate = IsolateData::Get()->transactionHandleTemplate;
+    if (handleTemplate.IsEmpty()) {
+        auto newTemplate = v8::FunctionTemplate::New(isolate);
+        newTemplate->InstanceTemplate()->SetInternalFieldCount(HANDLE_FIELD_COUNT);
+        handleTemplate.Reset(isolate, newTemplate);
+    }
+
+    auto handle = handleTemplate.Get(isolate)->InstanceTemplate()
+        ->NewInstance(isolate->GetCurrentContext()).ToLocalChecked();
+    handle->SetAlignedPointerInInternalField(HANDLE_TRANSACTION_FIELD, nullptr);
+    return handle;
+}
+
+bool IsTransactionHandle(v8::Local<v8::Value> transactionId) {
+    if (!transactionId->IsObject()) {
+        return false;
+    }
+    auto& handleTemplate = IsolateData::Get()->transactionHandleTemplate;
+    return !handleTemplate.IsEmpty() &&
+        handleTemplate.Get(v8::Isolate::GetCurrent())->HasInstance(transactionId);
+}
+
+bool IsValidTransactionId(v8::Local<v8::Value> transactionId) {
+    if (transactionId->IsString()) {
+        return transactionId.As<v8::String>()->Length() > 0;
+    }
+    return IsTransactionHandle(transactionId);
+}
+
+Transaction* GetTransaction(v8::Local<v8::Value> transactionId) {
+    if (IsTransactionHandle(transactionId)) {
+        return GetHandleTransaction(transactionId.As<v8::Object>());
+    }
+    return GetTransaction(utils::GetLocalPointer(transactionId));
+}
+
+Transaction* GetTaintedTransaction(v8::Local<v8::Value> transactionId) {
+    if (!IsolateData::Get()->taintedObjects.Any()) {
+        return nullptr;
+    }
+    auto transaction = GetTransaction(transactionId);
+    return transaction && transaction->GetTaintedCount() > 0 ? transaction : nullptr;
+}
+
+Transaction* NewTransaction(v8::Local<v8::Value> transactionId) {
+    if (!IsTransactionHandle(transactionId)) {
+        return NewTransaction(utils::GetLocalPointer(transactionId), transactionId);
+    }
+
+    auto handle = transactionId.As<v8::Object>();
+    auto transaction = GetHandleTransaction(handle);
+    if (transaction) {
+        transaction->SetMaxTaintedObjects(IsolateData::Get()->maxTaintedObjects);
+        return transaction;
+    }
+
+    transaction = NewTransaction(utils::GetLocalPointer(transactionId), transactionId);
+    handle->SetAlignedPointerInInternalField(HANDLE_TRANSACTION_FIELD, transaction);
+    return transaction;
+}
+
+void RemoveTransaction(v8::Local<v8::Value> transactionId) {
+    if (IsTransactionHandle(transactionId)) {
+        transactionId.As<v8::Object>()->SetAlignedPointerInInternalField(HANDLE_TRANSACTION_FIELD, nullptr);
+    }
+    RemoveTransaction(utils::GetLocalPointer(transactionId));
 }
 
 void Init(v8::Local<v8::Object> exports, v8::Isolate* isolate) {
@@ -55,8 +154,13 @@ void Init(v8::Local<v8::Object> exports, v8::Isolate* isolate) {
     api::StringCaseOperations::Init(exports);
     api::ArrayJoinOperations::Init(exports);
     api::Metrics::Init(exports);
-    isolate->AddGCEpilogueCallback(iast::gc::OnScavenge, v8::GCType::kGCTypeScavenge);
-    isolate->AddGCEpilogueCallback(iast::gc::OnMarkSweepCompact, v8::GCType::kGCTypeMarkSweepCompact);
+    auto data = IsolateData::Init(isolate);
+
+    // taintedFlag[0] is set while any value is tainted in the isolate.
+    auto flagBuffer = v8::ArrayBuffer::New(isolate, data->taintedFlagStore);
+    exports->Set(isolate->GetCurrentContext(),
+            utils::NewV8String(isolate, "taintedFlag"),
+            v8::Uint8Array::New(flagBuffer, 0, 1)).Check();
 }
 
 }   // namespace iast
@@ -13,17 +13,35 @@
 
 #include "transaction_manager.h"
 #include "tainted/transaction.h"
+#include "utils/range_compaction.h"
 
 using iast::tainted::Transaction;
 using iast::tainted::transaction_key_t;
 
 namespace iast {
 
-void RehashAllTransactions(void);
+void RehashAllTransactions(bool onlyYoung);
 void RemoveTransaction(transaction_key_t id);
 Transaction* GetTransaction(transaction_key_t id);
 Transaction* NewTransaction(transaction_key_t id, v8::Local<v8::Value> jsObject);
 void SetMaxTransactions(size_t maxItems);
+void SetMaxTaintedObjects(size_t maxItems);
+void SetRangeOverflowPolicy(utils::RangeOverflowPolicy policy);
+utils::RangeOverflowPolicy GetRangeOverflowPolicy();
+
+// Transactions can be identified either by a string or by a handle returned by
+// createTransaction, which keeps a pointer to its transaction so no lookup is needed.
+v8::Local<v8::Object> NewTransactionHandle(v8::Isolate* isolate);
+bool IsTransactionHandle(v8::Local<v8::Value> transactionId);
+bool IsValidTransactionId(v8::Local<v8::Value> transactionId);
+Transaction* GetTransaction(v8::Local<v8::Value> transactionId);
+Transaction* NewTransaction(v8::Local<v8::Value> transactionId);
+
+// Transaction for the propagation methods and isTainted, nullptr when it has no tainted
+// values, so there is nothing to propagate. The tainted objects of the isolate are
+// counted, and the transaction is not even looked up while no transaction has any.
+Transaction* GetTaintedTransaction(v8::Local<v8::Value> transactionId);
+void RemoveTransaction(v8::Local<v8::Value> transactionId);
 
 }  // namespace iast
 
@@ -10,9 +10,11 @@
 namespace iast {
 struct Limits {
     static const size_t MAX_RANGES = 50;
+    static const size_t INLINE_RANGES = 2;
     static const size_t MAX_TAINTED_OBJECTS = 4096;  // result of pow(2, 12);
-    static const size_t MAX_GLOBAL_TAINTED_RANGES = MAX_RANGES * MAX_TAINTED_OBJECTS;
     static const size_t MAX_TAINTED_RANGE_VECTORS = MAX_TAINTED_OBJECTS;
+    static const size_t POOL_BLOCK_SIZE = 256;
+    static const size_t TAINT_FILTER_BITS_PER_OBJECT = 16;
 };
 }  // namespace iast
 
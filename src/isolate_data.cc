@@ -0,0 +1,47 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <node.h>
+
+#include "isolate_data.h"
+
+namespace iast {
+
+thread_local IsolateData* IsolateData::current = nullptr;
+
+IsolateData* IsolateData::Init(v8::Isolate* isolate) {
+    // The addon may be initialized again in the same environment (e.g. after clearing
+    // the require cache), the data and the hooks are only set up the first time.
+    if (current == nullptr) {
+        current = new IsolateData(isolate);
+        isolate->AddGCEpilogueCallback(gc::OnScavenge, v8::GCType::kGCTypeScavenge);
+        isolate->AddGCEpilogueCallback(gc::OnMarkSweepCompact, v8::GCType::kGCTypeMarkSweepCompact);
+        node::AddEnvironmentCleanupHook(isolate, Cleanup, current);
+
+        current->taintedFlagStore = v8::ArrayBuffer::NewBackingStore(isolate, 1);
+        current->taintedObjects.SetFlag(static_cast<uint8_t*>(current->taintedFlagStore->Data()));
+    }
+    return current;
+}
+
+void IsolateData::Cleanup(void* arg) {
+    auto data = static_cast<IsolateData*>(arg);
+    data->_isolate->RemoveGCEpilogueCallback(gc::OnScavenge);
+    data->_isolate->RemoveGCEpilogueCallback(gc::OnMarkSweepCompact);
+    if (current == data) {
+        current = nullptr;
+    }
+    delete data;
+}
+
+IsolateData::~IsolateData() {
+    transactionManager.Clear();
+    transactionHandleTemplate.Reset();
+    startLabel.Reset();
+    endLabel.Reset();
+    iinfoLabel.Reset();
+    secureMarksLabel.Reset();
+}
+
+}  // namespace iast
@@ -0,0 +1,90 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#ifndef SRC_ISOLATE_DATA_H_
+#define SRC_ISOLATE_DATA_H_
+
+#include <v8.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "iastlimits.h"
+#include "transaction_manager.h"
+#include "gc/gc.h"
+#include "tainted/string_resource.h"
+#include "tainted/transaction.h"
+#include "utils/range_compaction.h"
+
+namespace iast {
+
+// Number of tainted objects in all the transactions of an isolate. While it is not zero
+// a byte shared with JS is set, so the JS wrappers of the propagation methods can skip
+// the native call when nothing can be propagated.
+class TaintedObjectsCounter {
+ public:
+    void Add(ptrdiff_t delta) noexcept {
+        _count += delta;
+        *_flag = _count > 0;
+    }
+
+    size_t Get() const noexcept { return _count; }
+    bool Any() const noexcept { return _count > 0; }
+
+    void SetFlag(uint8_t* flag) noexcept {
+        _flag = flag;
+        *_flag = _count > 0;
+    }
+
+ private:
+    size_t _count = 0;
+    uint8_t _ownFlag = 0;
+    uint8_t* _flag = &_ownFlag;
+};
+
+// State owned by every isolate that loads the addon (the main thread and each worker
+// thread), so isolates never share transactions, their pools or cached V8 values.
+// Node runs an isolate on a single thread for its whole life, so the data of the
+// running isolate is reached through a thread local pointer.
+class IsolateData {
+ public:
+    IsolateData(const IsolateData&) = delete;
+    IsolateData& operator =(const IsolateData&) = delete;
+
+    // Data of the isolate running in the current thread, nullptr before Init.
+    static IsolateData* Get() noexcept { return current; }
+
+    // Creates the data for the isolate, released when its environment is torn down.
+    static IsolateData* Init(v8::Isolate* isolate);
+
+    // Declared before the transactions, which update it until they are destroyed.
+    TaintedObjectsCounter taintedObjects;
+    std::shared_ptr<v8::BackingStore> taintedFlagStore;
+    TransactionManager<tainted::Transaction, tainted::transaction_key_t> transactionManager;
+    size_t maxTaintedObjects = Limits::MAX_TAINTED_OBJECTS;
+    utils::RangeOverflowPolicy rangeOverflowPolicy = utils::RangeOverflowPolicy::DROP_NEWEST;
+    v8::Persistent<v8::FunctionTemplate> transactionHandleTemplate;
+    tainted::SourceTypes sourceTypes;
+    tainted::StringResourcePool stringResources;
+
+    gc::RehashStats scavengeStats;
+    gc::RehashStats markSweepCompactStats;
+
+    v8::Persistent<v8::Value> startLabel;
+    v8::Persistent<v8::Value> endLabel;
+    v8::Persistent<v8::Value> iinfoLabel;
+    v8::Persistent<v8::Value> secureMarksLabel;
+
+ private:
+    explicit IsolateData(v8::Isolate* isolate) : _isolate(isolate) {}
+    ~IsolateData();
+
+    static void Cleanup(void* arg);
+
+    static thread_local IsolateData* current;
+    v8::Isolate* _isolate;
+};
+
+}  // namespace iast
+#endif  // SRC_ISOLATE_DATA_H_
@@ -3,11 +3,13 @@
 * This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
 **/
 #include <v8.h>
-#include <string>
+#include <algorithm>
+#include <cstring>
 
 #include "input_info.h"
 #include "../utils/jsobject_utils.h"
 #include "../iast_node.h"
+#include "../isolate_data.h"
 
 
 using v8::String;
@@ -16,69 +18,117 @@ using v8::Isolate;
 
 namespace iast {
 namespace tainted {
-InputInfo::InputInfo(v8::Local<v8::Value> parameterName,
-                 v8::Local<v8::Value> parameterValue, v8::Local<v8::Value> type) {
-    Isolate *isolate = v8::Isolate::GetCurrent();
-    this->parameterName.Reset(isolate, parameterName);
-    this->parameterValue.Reset(isolate, parameterValue);
-    this->type.Reset(isolate, type);
+namespace {
+// Code units compared at a time, read into a buffer on the stack.
+const int COMPARE_CHUNK = 64;
+}  // namespace
+
+void SourceString::Reset(Isolate* isolate, v8::Local<v8::Value> value, container::StringArena* arena) {
+    _handle.Reset();
+    _units = nullptr;
+    _length = 0;
+    if (value->IsString()) {
+        auto string = value.As<v8::String>();
+        auto units = arena->Allocate(string->Length());
+        string->Write(isolate, units, 0, -1, String::NO_NULL_TERMINATION);
+        _units = units;
+        _length = string->Length();
+    } else {
+        _handle.Reset(isolate, value);
+    }
 }
 
-InputInfo::InputInfo(const InputInfo& inputInfo) {
-    auto isolate = v8::Isolate::GetCurrent();
+v8::Local<v8::Value> SourceString::Get(Isolate* isolate) const {
+    if (!_handle.IsEmpty()) {
+        return v8::Local<v8::Value>::New(isolate, _handle);
+    }
+    if (_length == 0) {
+        return String::Empty(isolate);
+    }
+    return String::NewFromTwoByte(isolate, _units, NewStringType::kNormal, _length).ToLocalChecked();
+}
 
-    if (!inputInfo.parameterName.IsEmpty()) {
-        this->parameterName.Reset(isolate, inputInfo.parameterName);
-    } else {
-        this->parameterName.Reset();
+bool SourceString::Equals(Isolate* isolate, v8::Local<v8::Value> value) const {
+    if (!_handle.IsEmpty() || !value->IsString()) {
+        return !_handle.IsEmpty() && value->StrictEquals(v8::Local<v8::Value>::New(isolate, _handle));
     }
 
-    if (!inputInfo.parameterValue.IsEmpty()) {
-        this->parameterValue.Reset(isolate, inputInfo.parameterValue);
-    } else {
-        this->parameterValue.Reset();
+    auto string = value.As<v8::String>();
+    if (static_cast<uint32_t>(string->Length()) != _length) {
+        return false;
+    }
+    uint16_t buffer[COMPARE_CHUNK];
+    for (uint32_t start = 0; start < _length; start += COMPARE_CHUNK) {
+        int chunk = std::min<uint32_t>(COMPARE_CHUNK, _length - start);
+        string->Write(isolate, buffer, start, chunk, String::NO_NULL_TERMINATION);
+        if (memcmp(buffer, _units + start, chunk * sizeof(uint16_t)) != 0) {
+            return false;
+        }
     }
+    return true;
+}
 
+uint16_t SourceTypes::Intern(Isolate* isolate, v8::Local<v8::Value> type) {
+    if (!type->IsString()) {
+        return NOT_INTERNED;
+    }
+    for (size_t i = 0; i < _types.size(); i++) {
+        if (type->StrictEquals(_types[i].Get(isolate))) {
+            return static_cast<uint16_t>(i);
+        }
+    }
+    if (_types.size() >= MAX_TYPES) {
+        return NOT_INTERNED;
+    }
+    _types.emplace_back(isolate, type.As<v8::String>());
+    return static_cast<uint16_t>(_types.size() - 1);
+}
 
-    if (!inputInfo.type.IsEmpty()) {
-        this->type.Reset(isolate, inputInfo.type);
-    } else {
-        this->type.Reset();
+InputInfo::InputInfo(v8::Local<v8::Value> parameterName, v8::Local<v8::Value> parameterValue,
+        v8::Local<v8::Value> type, container::StringArena* names) {
+    Isolate *isolate = v8::Isolate::GetCurrent();
+    this->parameterName.Reset(isolate, parameterName, names);
+
+    auto data = IsolateData::Get();
+    if (data) {
+        this->typeIndex = data->sourceTypes.Intern(isolate, type);
+    }
+    if (this->typeIndex == SourceTypes::NOT_INTERNED) {
+        this->type.Reset(isolate, type, names);
     }
+    // last, the copies above may throw
+    this->parameterValue.Reset(isolate, parameterValue);
 }
 
 InputInfo::~InputInfo() {
-    if (!this->parameterName.IsEmpty()) {
-        this->parameterName.Reset();
-    }
     if (!this->parameterValue.IsEmpty()) {
         this->parameterValue.Reset();
     }
-    if (!this->type.IsEmpty()) {
-        this->type.Reset();
-    }
     if (this->inputInfoV8Container != nullptr) {
         delete this->inputInfoV8Container;
     }
 }
 
-InputInfo& InputInfo::operator=(const InputInfo& inputInfo) {
-    return *this;
+v8::Local<v8::Value> InputInfo::GetType(Isolate* isolate) const {
+    if (this->typeIndex == SourceTypes::NOT_INTERNED) {
+        return this->type.Get(isolate);
+    }
+    return IsolateData::Get()->sourceTypes.Get(isolate, this->typeIndex);
 }
 
-InputInfo* GetInputInfoFromJsObject(v8::Object* jsInputInfo, Isolate* isolate, v8::Local<v8::Context> context) {
-    auto parameterName = jsInputInfo->Get(context, utils::NewV8String(isolate, "parameterName")).ToLocalChecked();
-    auto parameterValue = jsInputInfo->Get(context, utils::NewV8String(isolate, "parameterValue")).ToLocalChecked();
-    auto typeValue = jsInputInfo->Get(context, utils::NewV8String(isolate, "type")).ToLocalChecked();
-    return new InputInfo(parameterName, parameterValue, typeValue);
+bool InputInfo::Matches(Isolate* isolate, v8::Local<v8::Value> parameterName,
+        v8::Local<v8::Value> parameterValue, v8::Local<v8::Value> type) const {
+    return this->parameterName.Equals(isolate, parameterName)
+        && type->StrictEquals(GetType(isolate))
+        && parameterValue->StrictEquals(GetParameterValue(isolate));
 }
 
 v8::Local<v8::Object> GetJsObjectFromInputInfo(Isolate* isolate, v8::Local<v8::Context> context, InputInfo *inputInfo) {
     if (inputInfo->inputInfoV8Container == nullptr) {
         auto iinfo = v8::Object::New(isolate);
-        auto parameterName = v8::Local<v8::Value>::New(isolate, inputInfo->parameterName);
-        auto parameterValue = v8::Local<v8::Value>::New(isolate, inputInfo->parameterValue);
-        auto type = v8::Local<v8::Value>::New(isolate, inputInfo->type);
+        auto parameterName = inputInfo->GetParameterName(isolate);
+        auto parameterValue = inputInfo->GetParameterValue(isolate);
+        auto type = inputInfo->GetType(isolate);
         iinfo->Set(context, utils::NewV8String(isolate, "parameterName"), parameterName).Check();
         iinfo->Set(context, utils::NewV8String(isolate, "parameterValue"), parameterValue).Check();
         iinfo->Set(context, utils::NewV8String(isolate, "type"), type).Check();
@@ -6,6 +6,10 @@
 #define SRC_TAINTED_INPUT_INFO_H_
 
 #include <v8.h>
+#include <cstdint>
+#include <vector>
+
+#include "../container/string_arena.h"
 
 namespace iast {
 namespace tainted {
@@ -18,23 +22,73 @@ class InputInfoV8Container {
     }
 };
 
+// Source metadata is almost always a string, kept as a native copy instead of a global
+// handle V8 would visit on every GC. The copy lives in an arena of the transaction, other
+// values fall back to a handle.
+class SourceString {
+ public:
+    SourceString() = default;
+    SourceString(const SourceString&) = delete;
+    SourceString& operator=(const SourceString&) = delete;
+    ~SourceString() { _handle.Reset(); }
+
+    // Throws std::bad_alloc when the arena cannot grow.
+    void Reset(v8::Isolate* isolate, v8::Local<v8::Value> value, container::StringArena* arena);
+    v8::Local<v8::Value> Get(v8::Isolate* isolate) const;
+    bool Equals(v8::Isolate* isolate, v8::Local<v8::Value> value) const;
+
+ private:
+    const uint16_t* _units = nullptr;
+    uint32_t _length = 0;
+    v8::Persistent<v8::Value> _handle;
+};
+
+// Source types are a handful of constants ("http.request.parameter", ...), interned
+// once per isolate so records only keep their index.
+class SourceTypes {
+ public:
+    static const uint16_t NOT_INTERNED = UINT16_MAX;
+    static const size_t MAX_TYPES = 64;
+
+    uint16_t Intern(v8::Isolate* isolate, v8::Local<v8::Value> type);
+    v8::Local<v8::String> Get(v8::Isolate* isolate, uint16_t index) const {
+        return _types[index].Get(isolate);
+    }
+
+ private:
+    std::vector<v8::Global<v8::String>> _types;
+};
+
+// Only the parameter value is held by a handle, name and type are materialized as JS
+// values when the record is read from JS (GetJsObjectFromInputInfo).
 struct InputInfo {
-    InputInfo(v8::Local<v8::Value> parameterName,
-            v8::Local<v8::Value> parameterValue, v8::Local<v8::Value> type);
-    InputInfo(const InputInfo& inputInfo);
+    InputInfo(v8::Local<v8::Value> parameterName, v8::Local<v8::Value> parameterValue,
+            v8::Local<v8::Value> type, container::StringArena* names);
+    InputInfo(const InputInfo& inputInfo) = delete;
     ~InputInfo();
 
-    InputInfo& operator=(const InputInfo& inputInfo);
+    InputInfo& operator=(const InputInfo& inputInfo) = delete;
+
+    v8::Local<v8::Value> GetParameterName(v8::Isolate* isolate) const {
+        return parameterName.Get(isolate);
+    }
+    v8::Local<v8::Value> GetParameterValue(v8::Isolate* isolate) const {
+        return v8::Local<v8::Value>::New(isolate, parameterValue);
+    }
+    v8::Local<v8::Value> GetType(v8::Isolate* isolate) const;
+
+    bool Matches(v8::Isolate* isolate, v8::Local<v8::Value> parameterName,
+            v8::Local<v8::Value> parameterValue, v8::Local<v8::Value> type) const;
 
     v8::Persistent<v8::Value> parameterValue;
-    v8::Persistent<v8::Value> parameterName;
-    v8::Persistent<v8::Value> type;
+    SourceString parameterName;
+    uint16_t typeIndex = SourceTypes::NOT_INTERNED;
+    // Only set for types that could not be interned.
+    SourceString type;
     InputInfoV8Container* inputInfoV8Container = nullptr;
 };
 
 
-InputInfo* GetInputInfoFromJsObject(v8::Object* jsInputInfo, v8::Isolate* isolate, v8::Local<v8::Context> context);
-
 v8::Local<v8::Object> GetJsObjectFromInputInfo(v8::Isolate* isolate,
         v8::Local<v8::Context> context,
         InputInfo *inputInfo);
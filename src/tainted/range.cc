@@ -5,6 +5,7 @@
 #include <node.h>
 
 #include "../iast_node.h"
+#include "../isolate_data.h"
 #include "range.h"
 #include "input_info.h"
 #include "../utils/jsobject_utils.h"
@@ -15,36 +16,19 @@ using v8::Isolate;
 
 namespace iast {
 namespace tainted {
-bool labelsDefined = false;
-v8::Persistent<v8::Value> startLabel;
-v8::Persistent<v8::Value> endLabel;
-v8::Persistent<v8::Value> iinfoLabel;
-v8::Persistent<v8::Value> secureMarksLabel;
-
-Range::Range(int start, int end, InputInfo *inputInfo, secure_marks_t secureMarks) {
-    this->start = start;
-    this->end = end;
-    this->inputInfo = inputInfo;
-    this->secureMarks = secureMarks;
-}
-
-Range::Range(const Range& range) {
-    this->start = range.start;
-    this->end = range.end;
-    this->inputInfo = range.inputInfo;
-    this->secureMarks = range.secureMarks;
-}
-
-Range::~Range() {}
-
-v8::Local<v8::Object> Range::toJSObject(v8::Isolate* isolate) {
+v8::Local<v8::Object> Range::toJSObject(v8::Isolate* isolate, InputInfo* inputInfo) const {
     auto context = isolate->GetCurrentContext();
     auto taintedRangev8Obj = v8::Object::New(isolate);
     v8::Local<v8::Value> startLabelLocal;
     v8::Local<v8::Value> endLabelLocal;
     v8::Local<v8::Value> iinfoLabelLocal;
     v8::Local<v8::Value> secureMarksLabelLocal;
-    if (!labelsDefined) {
+    auto data = IsolateData::Get();
+    auto& startLabel = data->startLabel;
+    auto& endLabel = data->endLabel;
+    auto& iinfoLabel = data->iinfoLabel;
+    auto& secureMarksLabel = data->secureMarksLabel;
+    if (startLabel.IsEmpty()) {
         startLabelLocal = utils::NewV8String(isolate, "start");
         endLabelLocal = utils::NewV8String(isolate, "end");
         iinfoLabelLocal = utils::NewV8String(isolate, "iinfo");
@@ -53,7 +37,6 @@ v8::Local<v8::Object> Range::toJSObject(v8::Isolate* isolate) {
         endLabel.Reset(isolate, endLabelLocal);
         iinfoLabel.Reset(isolate, iinfoLabelLocal);
         secureMarksLabel.Reset(isolate, secureMarksLabelLocal);
-        labelsDefined = true;
     } else {
         startLabelLocal = v8::Local<v8::Value>::New(isolate, startLabel);
         endLabelLocal = v8::Local<v8::Value>::New(isolate, endLabel);
@@ -65,7 +48,7 @@ v8::Local<v8::Object> Range::toJSObject(v8::Isolate* isolate) {
     taintedRangev8Obj->Set(context, endLabelLocal, v8::Number::New(isolate, this->end)).Check();
     taintedRangev8Obj->Set(context,
             iinfoLabelLocal,
-            GetJsObjectFromInputInfo(isolate, context, this->inputInfo)).Check();
+            GetJsObjectFromInputInfo(isolate, context, inputInfo)).Check();
     taintedRangev8Obj->Set(context, secureMarksLabelLocal, v8::Number::New(isolate, this->secureMarks)).Check();
 
     return taintedRangev8Obj;
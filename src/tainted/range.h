@@ -12,17 +12,21 @@
 namespace iast {
 namespace tainted {
 using secure_marks_t = uint32_t;
+using input_info_index_t = uint32_t;
+
+// Ranges are 16 byte values stored inline in the range lists, their source is the
+// index of its InputInfo in the transaction.
 class Range {
  public:
-    explicit Range(int start, int end, InputInfo *inputInfo, secure_marks_t secureMarks);
-    Range(const Range& taintedRange);
-    ~Range();
-    v8::Local<v8::Object> toJSObject(v8::Isolate* isolate);
+    Range(int start, int end, input_info_index_t inputInfoIndex, secure_marks_t secureMarks)
+        : start(start), end(end), inputInfoIndex(inputInfoIndex), secureMarks(secureMarks) {}
+    v8::Local<v8::Object> toJSObject(v8::Isolate* isolate, InputInfo* inputInfo) const;
     int start;
     int end;
-    InputInfo* inputInfo;
+    input_info_index_t inputInfoIndex;
     secure_marks_t secureMarks;
 };
+static_assert(sizeof(Range) == 16, "ranges are packed in 16 bytes");
 }    // namespace tainted
 }    // namespace iast
 #endif  // SRC_TAINTED_RANGE_H_
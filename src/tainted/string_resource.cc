@@ -2,31 +2,107 @@
 * Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
 * This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
 **/
-#include <string>
-#include <codecvt>
-#include <locale>
+#include <memory>
 #include "string_resource.h"
+#include "../isolate_data.h"
 
 namespace iast {
 namespace tainted {
 
-void StringResource::CopyCharArrToUint16Arr(const char* charArr, uint16_t* result) {
-    std::string originalString(charArr);
-    std::u16string utf16 = std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>{}.
-        from_bytes(originalString.data());
-    int i = 0;
-    for (char16_t c : utf16) {
-        result[i] = c;
-        i++;
+namespace {
+// Strings copied by NewStringCopy up to this length do not touch the heap.
+const int STACK_COPY_LENGTH = 64;
+
+template<typename C, typename F>
+void WithBuffer(int length, F fn) {
+    C stackBuffer[STACK_COPY_LENGTH];
+    std::unique_ptr<C[]> heapBuffer;
+    C* buffer = stackBuffer;
+    if (length > STACK_COPY_LENGTH) {
+        heapBuffer.reset(new C[length]);
+        buffer = heapBuffer.get();
+    }
+    fn(buffer);
+}
+}  // namespace
+
+void StringResource::Assign(v8::Isolate* isolate, v8::Local<v8::String> value) {
+    int length = value->Length();
+    releaseData();
+    if (length > INLINE_LENGTH) {
+        _data = new uint16_t[length];
+    }
+    value->Write(isolate, _data, 0, length, v8::String::NO_NULL_TERMINATION);
+    _length = length;
+}
+
+void StringResource::Dispose() {
+    auto data = IsolateData::Get();
+    if (!IsInline() || data == nullptr || !data->stringResources.Push(this)) {
+        delete this;
+    }
+}
+
+StringResourcePool::~StringResourcePool() {
+    while (auto resource = Pop()) {
+        delete resource;
+    }
+}
+
+StringResource* StringResourcePool::Pop() noexcept {
+    auto resource = _head;
+    if (resource) {
+        _head = resource->_next;
+        resource->_next = nullptr;
+        _size--;
+    }
+    return resource;
+}
+
+bool StringResourcePool::Push(StringResource* resource) noexcept {
+    if (_size >= MAX_FREE_RESOURCES) {
+        return false;
     }
+    resource->_next = _head;
+    _head = resource;
+    _size++;
+    return true;
 }
 
 v8::Local<v8::String> NewExternalString(v8::Isolate* isolate, v8::Local<v8::Value> obj) {
-    v8::String::Utf8Value originalStringValue(isolate, obj);
-    const char* originalCharArr = *originalStringValue;
-    int length = v8::Local<v8::String>::Cast(obj)->Length();
-    auto resource = new StringResource(originalCharArr, length);
+    auto value = obj->IsString() ? obj.As<v8::String>()
+        : obj->ToString(isolate->GetCurrentContext()).ToLocalChecked();
+
+    StringResource* resource = nullptr;
+    auto data = IsolateData::Get();
+    if (data && value->Length() <= StringResource::INLINE_LENGTH) {
+        resource = data->stringResources.Pop();
+    }
+    if (resource) {
+        resource->Assign(isolate, value);
+    } else {
+        resource = new StringResource(isolate, value);
+    }
     return v8::String::NewExternalTwoByte(isolate, resource).ToLocalChecked();
 }
+
+v8::Local<v8::String> NewStringCopy(v8::Isolate* isolate, v8::Local<v8::String> value) {
+    int length = value->Length();
+    v8::Local<v8::String> copy;
+    if (value->IsOneByte()) {
+        WithBuffer<uint8_t>(length, [&](uint8_t* buffer) {
+            value->WriteOneByte(isolate, buffer, 0, length, v8::String::NO_NULL_TERMINATION);
+            copy = v8::String::NewFromOneByte(isolate, buffer, v8::NewStringType::kNormal, length)
+                .ToLocalChecked();
+        });
+    } else {
+        WithBuffer<uint16_t>(length, [&](uint16_t* buffer) {
+            value->Write(isolate, buffer, 0, length, v8::String::NO_NULL_TERMINATION);
+            copy = v8::String::NewFromTwoByte(isolate, buffer, v8::NewStringType::kNormal, length)
+                .ToLocalChecked();
+        });
+    }
+    return copy;
+}
 }  // namespace tainted
 }  // namespace iast
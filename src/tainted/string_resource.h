@@ -5,40 +5,89 @@
 #ifndef SRC_TAINTED_STRING_RESOURCE_H_
 #define SRC_TAINTED_STRING_RESOURCE_H_
 #include <node.h>
-#include <string>
+#include <cstddef>
+#include <cstdint>
 
 namespace iast {
 namespace tainted {
+
+// Two-byte copy of a string backing an external string. Short strings (tainted
+// propagation results are mostly single characters) are stored in the resource itself
+// and, once V8 disposes the resource, it goes back to the StringResourcePool of the
+// isolate to be reused.
 class StringResource : public v8::String::ExternalStringResource {
  public:
-    explicit StringResource(const char* dataChars, int length) {
-        this->length_ = length;
-        auto data = new uint16_t[length];
-        CopyCharArrToUint16Arr(dataChars, data);
-        this->data_ = data;
+    static const int INLINE_LENGTH = 8;
+
+    StringResource(v8::Isolate* isolate, v8::Local<v8::String> value) {
+        Assign(isolate, value);
+    }
+    ~StringResource() { releaseData(); }
+
+    const uint16_t* data() const override { return _data; }
+    size_t length() const override { return _length; }
+
+    // Copies the value with String::Write, straight from its UTF-16 code units.
+    void Assign(v8::Isolate* isolate, v8::Local<v8::String> value);
+
+    bool IsInline() const noexcept { return _data == _inline; }
+
+ protected:
+    void Dispose() override;
+
+ private:
+    friend class StringResourcePool;
+
+    void releaseData() noexcept {
+        if (!IsInline()) {
+            delete[] _data;
+        }
+        _data = _inline;
     }
-    ~StringResource() { delete[] this->data_; }
 
-    virtual const uint16_t* data() const { return data_; }
-    virtual size_t length()  const { return length_; }
+    uint16_t* _data = _inline;
+    size_t _length = 0;
+    uint16_t _inline[INLINE_LENGTH];
+    StringResource* _next = nullptr;
+};
+
+// Free list of inline resources disposed by V8. Resources are disposed by the GC on the
+// thread of their isolate, and outlive the transaction of the value they hold, so the
+// list is kept per isolate. Resources disposed once the isolate data is gone are deleted.
+class StringResourcePool {
+ public:
+    static const size_t MAX_FREE_RESOURCES = 1024;
+
+    StringResourcePool() = default;
+    StringResourcePool(const StringResourcePool&) = delete;
+    StringResourcePool& operator =(const StringResourcePool&) = delete;
+    ~StringResourcePool();
+
+    // nullptr when the list is empty.
+    StringResource* Pop() noexcept;
+
+    // Returns false when the resource was not kept.
+    bool Push(StringResource* resource) noexcept;
+
+    size_t Size() const noexcept { return _size; }
 
  private:
-    void CopyCharArrToUint16Arr(const char* charArr, uint16_t* result);     const uint16_t* data_;
-    int length_ = 0;
+    StringResource* _head = nullptr;
+    size_t _size = 0;
 };
 
 v8::Local<v8::String> NewExternalString(v8::Isolate* isolate, v8::Local<v8::Value> obj);
+
+// New, not internalized, copy of a string, so tainting it does not taint other uses of
+// the same value. Characters are copied without going through UTF-8.
+v8::Local<v8::String> NewStringCopy(v8::Isolate* isolate, v8::Local<v8::String> value);
+
 inline v8::Local<v8::String> NewStringInstanceForNewTaintedObject(v8::Isolate* isolate, v8::Local<v8::String> obj) {
-    int len =  obj->Length();
-    if (len == 1) {
+    if (obj->Length() == 1) {
         return tainted::NewExternalString(isolate, obj);
-    } else {
-        v8::String::Utf8Value param1(isolate, obj);
-        std::string cppStr(*param1);
-        return v8::String::NewFromUtf8(isolate, cppStr.c_str(), v8::NewStringType::kNormal).ToLocalChecked();
     }
+    return tainted::NewStringCopy(isolate, obj);
 }
 }  // namespace tainted
 }  // namespace iast
 #endif  // SRC_TAINTED_STRING_RESOURCE_H_
-
@@ -15,10 +15,10 @@
 #include "../utils/string_utils.h"
 #include "../container/pool.h"
 #include "../container/weakmap.h"
-#include "../container/shared_vector.h"
+#include "../container/range_list.h"
 #include "../iastlimits.h"
 
-using SharedRanges = iast::container::SharedVector<iast::tainted::Range*>;
+using SharedRanges = iast::container::RangeList<iast::tainted::Range, iast::Limits::INLINE_RANGES>;
 namespace iast {
 namespace tainted {
 class TaintedObject: public iast::WeakObjIface<TaintedObject*> {
@@ -33,7 +33,7 @@ class TaintedObject: public iast::WeakObjIface<TaintedObject*> {
     bool IsEmpty() { return target.IsEmpty(); }
 
     weak_key_t Get() {
-        return utils::GetLocalPointer(target.Get(v8::Isolate::GetCurrent()));
+        return utils::GetTaintKey(target.Get(v8::Isolate::GetCurrent()));
     }
 
     void Reset(v8::Local<v8::Value> v) {
@@ -44,7 +44,6 @@ class TaintedObject: public iast::WeakObjIface<TaintedObject*> {
         target.Reset();
     }
 
-    v8::Local<v8::Object> toJSObject(v8::Isolate* isolate);
     SharedRanges* getRanges(void) { return _ranges; }
     void setRanges(SharedRanges* ranges) { _ranges = ranges; }
 
@@ -9,22 +9,40 @@
 #include <vector>
 #include <queue>
 #include <memory>
+#include <new>
 
 #include "../gc/gc.h"
 #include "../utils/jsobject_utils.h"
 #include "transaction.h"
+#include "../isolate_data.h"
 #include "../container/weakmap.h"
 
 namespace iast {
 namespace tainted {
 
+namespace {
+// Folds value into hash with a Fibonacci multiply, as WeakMap does with its keys, so every
+// 32 bit identity hash reaches all the bits of the result instead of overlapping the others.
+uint64_t mixHash(uint64_t hash, uint32_t value) {
+    hash = (hash ^ value) * 0x9E3779B97F4A7C15ull;
+    return hash ^ (hash >> 32);
+}
+}  // namespace
+
 void Transaction::Clean() noexcept {
+    auto taintedCount = GetTaintedCount();
     _taintedMap.Clean();
-    cleanInputInfos();
-    _rangesPool.Clear();
-    cleanSharedVectors();
+    updateTaintedObjects(taintedCount);
+    _taintFilter.Clear();
+    _filterKeys = 0;
+    _filterStats = FilterStats();
+    _inputInfos.Clear();
+    _inputInfoTable.clear();
+    _inputInfoPool.Clear();
+    _sourceNames.Clear();
     _sharedRangesPool.Clear();
     _taintedObjPool.Clear();
+    _droppedTaints = 0;
 
     // Clean up V8 persistent reference
     if (!_jsObjectRef.IsEmpty()) {
@@ -36,33 +54,78 @@ Transaction::~Transaction() noexcept {
     Clean();
 }
 
-void Transaction::cleanInputInfos() noexcept {
-    for (std::vector<InputInfo *>::iterator it = _usedInputInfo.begin();
-         it != _usedInputInfo.end(); ++it) {
-        if (*it) {
-            delete *it;
-        }
+void Transaction::updateTaintedObjects(int previousCount) noexcept {
+    auto delta = GetTaintedCount() - previousCount;
+    auto data = IsolateData::Get();
+    if (delta != 0 && data) {
+        data->taintedObjects.Add(delta);
     }
-    _usedInputInfo.resize(0);
 }
 
-void Transaction::cleanSharedVectors() {
-    while (!_usedSharedRanges.empty()) {
-        auto sr = _usedSharedRanges.front();
-        _sharedRangesPool.Push(sr);
-        _usedSharedRanges.pop();
+void Transaction::rebuildFilter() noexcept {
+    _taintFilter.Clear();
+    _filterKeys = 0;
+    _taintedMap.ForEachKey([this](weak_key_t key) {
+        _taintFilter.Add(key);
+        _filterKeys++;
+    });
+}
+
+// A filter that cannot grow keeps working with a higher false positive rate.
+void Transaction::growFilter() noexcept {
+    try {
+        _taintFilter.Reset(_taintedMap.GetCapacity());
+    } catch (const std::bad_alloc&) {
+        return;
     }
+    rebuildFilter();
 }
 
-InputInfo* Transaction::createNewInputInfo(v8::Local<v8::Value> parameterName,
+input_info_index_t Transaction::createNewInputInfo(v8::Local<v8::Value> parameterName,
         v8::Local<v8::Value> parameterValue,
         v8::Local<v8::Value> type) {
-    InputInfo* newInputInfo = new InputInfo(parameterName, parameterValue, type);
-    if (newInputInfo != nullptr) {
-      _usedInputInfo.push_back(newInputInfo);
+    bool shareable = parameterName->IsString() && parameterValue->IsString() && type->IsString();
+    uint64_t hash = 0;
+    if (shareable) {
+        // string hashes only depend on their content
+        hash = mixHash(hash, parameterName.As<v8::String>()->GetIdentityHash());
+        hash = mixHash(hash, type.As<v8::String>()->GetIdentityHash());
+        hash = mixHash(hash, parameterValue.As<v8::String>()->GetIdentityHash());
+        input_info_index_t index;
+        if (findInputInfo(hash, parameterName, parameterValue, type, &index)) {
+            return index;
+        }
+    }
+
+    InputInfo* newInputInfo;
+    try {
+        newInputInfo = _inputInfoPool.Pop(parameterName, parameterValue, type, &_sourceNames);
+    } catch (const container::PoolBadAlloc&) {
+        _droppedTaints++;
+        throw;
+    }
+    input_info_index_t index = _inputInfoTable.size();
+    try {
+        _inputInfoTable.push_back(newInputInfo);
+    } catch (const std::bad_alloc&) {
+        _inputInfoPool.Push(newInputInfo);
+        throw;
+    }
+    if (shareable) {
+        _inputInfos.Insert(hash, index);
+    }
+    return index;
+}
+
+bool Transaction::findInputInfo(uint64_t hash, v8::Local<v8::Value> parameterName,
+        v8::Local<v8::Value> parameterValue, v8::Local<v8::Value> type, input_info_index_t* index) const {
+    auto found = _inputInfos.Find(hash);
+    if (!found) {
+        return false;
     }
 
-    return newInputInfo;
+    *index = *found;
+    return GetInputInfo(*index)->Matches(v8::Isolate::GetCurrent(), parameterName, parameterValue, type);
 }
 }  // namespace tainted
 }  // namespace iast
@@ -15,14 +15,21 @@
 
 #include "../tainted/range.h"
 #include "../tainted/tainted_object.h"
+#include "../container/bloom_filter.h"
+#include "../container/flat_map.h"
 #include "../container/queued_pool.h"
-#include "../container/shared_vector.h"
+#include "../container/range_list.h"
+#include "../container/string_arena.h"
 
-using SharedRanges = iast::container::SharedVector<iast::tainted::Range*>;
+using SharedRanges = iast::container::RangeList<iast::tainted::Range, iast::Limits::INLINE_RANGES>;
 using WeakMap = iast::container::WeakMap<iast::tainted::TaintedObject*, iast::Limits::MAX_TAINTED_OBJECTS>;
-using TaintedPool = iast::container::Pool<iast::tainted::TaintedObject, iast::Limits::MAX_TAINTED_OBJECTS>;
-using RangePool = iast::container::Pool<iast::tainted::Range, iast::Limits::MAX_GLOBAL_TAINTED_RANGES>;
-using SharedRangesPool = iast::container::QueuedPool<SharedRanges, iast::Limits::MAX_TAINTED_OBJECTS>;
+using TaintedPool = iast::container::Pool<iast::tainted::TaintedObject, iast::Limits::MAX_TAINTED_OBJECTS,
+      iast::Limits::POOL_BLOCK_SIZE>;
+using SharedRangesPool = iast::container::Pool<SharedRanges, iast::Limits::MAX_TAINTED_OBJECTS,
+      iast::Limits::POOL_BLOCK_SIZE>;
+using TaintFilter = iast::container::BloomFilter<iast::Limits::TAINT_FILTER_BITS_PER_OBJECT>;
+using InputInfoPool = iast::container::Pool<iast::tainted::InputInfo, iast::Limits::MAX_TAINTED_OBJECTS,
+      iast::Limits::POOL_BLOCK_SIZE>;
 
 namespace iast {
 namespace tainted {
@@ -36,46 +43,139 @@ class Transaction {
     ~Transaction() noexcept;
     void Clean(void) noexcept;
 
-    InputInfo* createNewInputInfo(v8::Local<v8::Value> parameterName,
+    // Sources with the same parameterName, parameterValue and type (all of them strings)
+    // share one record. Records live until the transaction is cleaned and are referenced
+    // by ranges through the returned index.
+    input_info_index_t createNewInputInfo(v8::Local<v8::Value> parameterName,
             v8::Local<v8::Value> parameterValue,
             v8::Local<v8::Value> type);
 
-    Range* GetRange(int start, int end, InputInfo *inputInfo, secure_marks_t secureMarks) {
-        return _rangesPool.Pop(start, end, inputInfo, secureMarks);
+    InputInfo* GetInputInfo(input_info_index_t index) const noexcept {
+        return _inputInfoTable[index];
     }
 
     SharedRanges* GetSharedVectorRange(void) {
-        auto sharedRanges = _sharedRangesPool.Pop();
-        _usedSharedRanges.push(sharedRanges);
-        return sharedRanges;
+        try {
+            return _sharedRangesPool.Pop();
+        } catch (const container::PoolBadAlloc&) {
+            _droppedTaints++;
+            throw;
+        }
     }
 
+    // Most lookups are for values that are not tainted, the filter answers them without
+    // probing the map.
     TaintedObject* FindTaintedObject(weak_key_t stringPointer) noexcept {
-        return _taintedMap.Find(stringPointer);
+        if (!_taintFilter.MayContain(stringPointer)) {
+            _filterStats.negatives++;
+            return nullptr;
+        }
+        auto tainted = _taintedMap.Find(stringPointer);
+        if (tainted) {
+            _filterStats.positives++;
+        } else {
+            _filterStats.falsePositives++;
+        }
+        return tainted;
     }
 
     int GetTaintedCount() {
         return _taintedMap.GetCount();
     }
 
-    void RehashMap(void) noexcept {
-        _taintedMap.Rehash();
+    // Taint operations given up because one of the transaction limits was reached.
+    size_t GetDroppedTaints() const noexcept {
+        return _droppedTaints;
     }
 
-    void AddTainted(weak_key_t key, SharedRanges* ranges, v8::Local<v8::Value> jsValue) {
-        // TODO(julio): trigger exception from the pool rather than a nullptr
-        auto tainted = _taintedObjPool.Pop(key,
-                ranges,
-                jsValue);
-        if (tainted) {
-            _taintedMap.Insert(key, tainted);
+    // The map and the pools grow on demand up to maxTaintedObjects.
+    void SetMaxTaintedObjects(size_t maxTaintedObjects) noexcept {
+        _taintedMap.SetMaxElements(maxTaintedObjects);
+        _taintedObjPool.SetCapacity(maxTaintedObjects);
+        _sharedRangesPool.SetCapacity(maxTaintedObjects);
+        _inputInfoPool.SetCapacity(maxTaintedObjects);
+    }
+
+    size_t GetCommittedMemory() const noexcept {
+        return _taintedObjPool.CommittedBytes() + _sharedRangesPool.CommittedBytes() + _inputInfoPool.CommittedBytes()
+            + _sourceNames.CommittedBytes();
+    }
+
+    size_t GetReservedMemory() const noexcept {
+        return _taintedObjPool.ReservedBytes() + _sharedRangesPool.ReservedBytes() + _inputInfoPool.ReservedBytes()
+            + _sourceNames.CommittedBytes();
+    }
+
+    struct FilterStats {
+        size_t negatives = 0;       // lookups answered by the filter
+        size_t positives = 0;       // lookups that went on to the map and found the value
+        size_t falsePositives = 0;  // lookups that went on to the map for nothing
+    };
+
+    const FilterStats& GetFilterStats() const noexcept {
+        return _filterStats;
+    }
+
+    size_t GetFilterSizeBytes() const noexcept {
+        return _taintFilter.GetSizeBytes();
+    }
+
+    // Keys moved by the GC are added to the filter again. After a scavenge only the young
+    // entries can have moved, so their keys are added on top of the stale ones; the filter
+    // is rebuilt once the keys added outnumber twice the live ones, and after every full GC.
+    void RehashMap(bool onlyYoung = false) noexcept {
+        auto taintedCount = GetTaintedCount();
+        _taintedMap.Rehash(onlyYoung);
+        updateTaintedObjects(taintedCount);
+        if (onlyYoung && _filterKeys <= 2 * static_cast<size_t>(_taintedMap.GetCount())) {
+            _taintedMap.ForEachKey([this](weak_key_t key) {
+                _taintFilter.Add(key);
+                _filterKeys++;
+            }, true);
+        } else {
+            rebuildFilter();
+        }
+    }
+
+    // Returns false when the value could not be added to the map (it is full), the
+    // pools throw when they are exhausted.
+    bool AddTainted(weak_key_t key, SharedRanges* ranges, v8::Local<v8::Value> jsValue) {
+        auto taintedCount = GetTaintedCount();
+        TaintedObject* tainted;
+        try {
+            tainted = _taintedObjPool.Pop(key,
+                    ranges,
+                    jsValue);
+        } catch (const container::PoolBadAlloc&) {
+            _droppedTaints++;
+            throw;
+        }
+
+        // A value tainted again (e.g. '' + a returns a) replaces its previous entry.
+        TaintedObject* replaced;
+        if (_taintedMap.Insert(key, tainted, utils::HasStableTaintKey(jsValue), &replaced) != WEAK_MAP_SUCCESS) {
+            _taintedObjPool.Push(tainted);
+            _droppedTaints++;
+            return false;
         }
+        _taintedObjPool.Push(replaced);
+        updateTaintedObjects(taintedCount);
+        _taintFilter.Add(key);
+        _filterKeys++;
+        if (_taintedMap.GetCapacity() > _taintFilter.GetCapacity()) {
+            growFilter();
+        }
+        return true;
     }
 
     bool HasJsObjectReference() const noexcept {
         return !_jsObjectRef.IsEmpty();
     }
 
+    bool IsReferencedBy(v8::Local<v8::Value> jsObject) const noexcept {
+        return _jsObjectRef == jsObject;
+    }
+
     transaction_key_t GetCurrentTransactionKey() const noexcept {
         if (_jsObjectRef.IsEmpty()) {
             return _id;
@@ -112,16 +212,28 @@ class Transaction {
     }
 
  private:
-    void cleanSharedVectors(void);
-    void cleanInputInfos(void) noexcept;
+    bool findInputInfo(uint64_t hash, v8::Local<v8::Value> parameterName,
+            v8::Local<v8::Value> parameterValue, v8::Local<v8::Value> type, input_info_index_t* index) const;
+    // Reports the change in the number of tainted objects to the isolate.
+    void updateTaintedObjects(int previousCount) noexcept;
+    void rebuildFilter() noexcept;
+    void growFilter() noexcept;
     TaintedPool _taintedObjPool;
-    std::queue<SharedRanges*> _usedSharedRanges;
     SharedRangesPool _sharedRangesPool;
     WeakMap _taintedMap;
-    RangePool _rangesPool;
-    std::vector<InputInfo*> _usedInputInfo;
+    // Sized like the map, it holds the key of every entry and possibly stale ones.
+    TaintFilter _taintFilter{WeakMap::INITIAL_CAPACITY};
+    size_t _filterKeys = 0;
+    FilterStats _filterStats;
+    InputInfoPool _inputInfoPool;
+    // Parameter names of the records, copied as UTF-16.
+    container::StringArena _sourceNames;
+    std::vector<InputInfo*> _inputInfoTable;
+    // Deduplicated records by the hash of their strings, the last one wins on collisions.
+    container::FlatMap<uint64_t, input_info_index_t> _inputInfos;
     transaction_key_t _id;
     v8::Persistent<v8::Value> _jsObjectRef;
+    size_t _droppedTaints = 0;
 };
 
 }  // namespace tainted
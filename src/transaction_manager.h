@@ -7,15 +7,18 @@
 
 #include <v8.h>
 #include <cstdint>
-#include <map>
 #include <iostream>
 #include <vector>
 
+#include "container/flat_map.h"
 #include "container/queued_pool.h"
 
 
 namespace iast {
 
+// Transactions are kept in a flat hash table keyed by the transaction id pointer. The
+// last transaction looked up is cached as well, since consecutive calls usually come
+// from the same request.
 template <typename T, typename U>
 class TransactionManager {
  public:
@@ -24,9 +27,9 @@ class TransactionManager {
     void operator=(TransactionManager const&) = delete;
 
     T* New(U id, v8::Local<v8::Value> jsObject) {
-        auto found = _map.find(id);
-        if (found == _map.end()) {
-            if (_map.size() >= _maxItems) {
+        auto found = _map.Find(id);
+        if (found == nullptr) {
+            if (_map.Size() >= _maxItems) {
                 return nullptr;
             }
 
@@ -37,42 +40,51 @@ class TransactionManager {
             } else {
                 item = _pool.Pop(id, jsObject);
             }
-            _map[id] = item;
+            _map.Insert(id, item);
+            cache(id, item);
             return item;
         } else {
-            auto item = found->second;
+            auto item = *found;
             if (item) {
                 item->UpdateJsObjectReference(jsObject);
             }
+            cache(id, item);
             return item;
         }
     }
 
     T* Get(U id) {
-        auto found = _map.find(id);
-        if (found == _map.end()) {
+        if (_lastId == id && _lastItem) {
+            return _lastItem;
+        }
+
+        auto found = _map.Find(id);
+        if (found == nullptr) {
             return nullptr;
-        } else {
-            return found->second;
         }
+        cache(id, *found);
+        return *found;
     }
 
     void Remove(U id) noexcept {
-        auto found = _map.find(id);
-        if (found != _map.end()) {
-            T* item = found->second;
-            _map.erase(found);
+        auto found = _map.Find(id);
+        if (found != nullptr) {
+            T* item = *found;
+            _map.Erase(id);
+            if (_lastItem == item) {
+                cache(0, nullptr);
+            }
             item->Clean();
             _pool.Push(item);
         }
     }
 
-    void RehashAll(void) noexcept {
-        for (auto entry : _map) {
-            if (entry.second) {
-                entry.second->RehashMap();
+    void RehashAll(bool onlyYoung = false) noexcept {
+        _map.ForEach([onlyYoung](U, T* item) {
+            if (item) {
+                item->RehashMap(onlyYoung);
             }
-        }
+        });
 
         RehashTransactionKeys();
     }
@@ -81,48 +93,55 @@ class TransactionManager {
         std::vector<std::pair<U, T*>> toReinsert;
 
         // Find transactions whose keys have changed due to GC
-        for (auto it = _map.begin(); it != _map.end();) {
-            auto transaction = it->second;
+        _map.ForEach([&toReinsert](U id, T* transaction) {
             if (transaction && transaction->HasJsObjectReference()) {
                 auto currentKey = transaction->GetCurrentTransactionKey();
-                auto originalKey = transaction->GetOriginalTransactionKey();
-
-                if (currentKey != originalKey) {
-                    // Key has changed due to GC, need to re-insert with new key
-                    toReinsert.push_back({currentKey, transaction});
-                    transaction->UpdateTransactionKey(currentKey);
-                    it = _map.erase(it);
-                } else {
-                    ++it;
+                if (currentKey != id) {
+                    toReinsert.push_back({id, transaction});
                 }
-            } else {
-                ++it;
             }
-        }
+        });
 
-        // Re-insert transactions with updated keys
+        // Every key is taken out before any is inserted again, as a new key may still
+        // be used by a transaction that moved too.
         for (auto& pair : toReinsert) {
-            _map[pair.first] = pair.second;
+            _map.Erase(pair.first);
         }
+        for (auto& pair : toReinsert) {
+            auto currentKey = pair.second->GetCurrentTransactionKey();
+            pair.second->UpdateTransactionKey(currentKey);
+            _map.Insert(currentKey, pair.second);
+        }
+
+        // The cached id may now belong to another object
+        cache(0, nullptr);
     }
 
     void Clear(void) noexcept {
-        for (auto it = _map.begin(); it != _map.end(); ++it) {
-            it->second->Clean();
-            _pool.Push(it->second);
-        }
-        _map.clear();
+        _map.ForEach([this](U, T* item) {
+            item->Clean();
+            _pool.Push(item);
+        });
+        _map.Clear();
         _pool.Clear();
+        cache(0, nullptr);
     }
 
-    size_t Size() noexcept { return _map.size(); }
+    size_t Size() noexcept { return _map.Size(); }
     void setMaxItems(size_t max) noexcept { _maxItems = max; }
     int getMaxItems(void) noexcept { return _maxItems; }
 
  private:
     size_t _maxItems = 2;
     container::QueuedPool<T> _pool;
-    std::map<U, T*> _map;
+    container::FlatMap<U, T*> _map;
+    U _lastId = 0;
+    T* _lastItem = nullptr;
+
+    void cache(U id, T* item) noexcept {
+        _lastId = id;
+        _lastItem = item;
+    }
 };
 
 }   // namespace iast
@@ -3,6 +3,10 @@
 * This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
 **/
 #include "propagation.h"
+#include "range_compaction.h"
+#include "range_kernels.h"
+#include "../iastlimits.h"
+#include "../isolate_data.h"
 
 namespace iast {
 namespace utils {
@@ -10,57 +14,37 @@ using tainted::Transaction;
 using tainted::TaintedObject;
 
 SharedRanges* getRangesInSlice(Transaction* transaction, TaintedObject* obj, int sliceStart, int sliceEnd) {
-    SharedRanges* newRanges = nullptr;
     SharedRanges* oRanges = nullptr;
 
     if (!transaction || !obj || !(oRanges = obj->getRanges())) {
-        return newRanges;
+        return nullptr;
     }
 
-    int resultLength = sliceEnd - sliceStart;
-    for (auto it = oRanges->begin(); it != oRanges->end(); ++it) {
-        auto oRange = *it;
-        int start, end;
-
-        if ((oRange->start < sliceStart) && (oRange->end <= sliceStart)) {
-            // range out of bounds (left)
-            continue;
-        }
-
-        if (oRange->start >= sliceEnd) {
-            // out of bounds (right), no need to keep iterating
-            break;
-        }
-
-        if ((oRange->start <= sliceStart) && (oRange->end > sliceEnd)) {
-            // range greater than slice
-            start = 0;
-            end = oRange->end - sliceStart;
-        } else if ((oRange->start >= sliceStart) && (oRange->end <= sliceEnd)) {
-            // range contained
-            start = oRange->start - sliceStart;
-            end = oRange->end - sliceStart;
-        } else if ((oRange->start < sliceStart) && (oRange->end <= sliceEnd)) {
-            // parcial left
-            start = 0;
-            end = oRange->end - sliceStart;
-        } else {
-            // parcial right
-            start = oRange->start - sliceStart;
-            end = sliceEnd;
-        }
-
-        if (end > resultLength) {
-            end = resultLength;
-        }
+    // Sliced into a list on the stack, so a pooled list is only taken when a range is
+    // kept. Assigning it afterwards shares its storage instead of copying it.
+    SharedRanges sliced;
+    auto count = oRanges->Size();
+    auto copied = kernels::SliceRanges(oRanges->begin(), sliced.Extend(count), count, sliceStart, sliceEnd);
+    if (copied == 0) {
+        return nullptr;
+    }
+    sliced.Truncate(copied);
 
-        if (!newRanges) {
-            newRanges = transaction->GetSharedVectorRange();
-        }
+    auto newRanges = transaction->GetSharedVectorRange();
+    *newRanges = sliced;
+    return newRanges;
+}
 
-        newRanges->PushBack(transaction->GetRange(start, end, oRange->inputInfo, oRange->secureMarks));
+void CompactRanges(SharedRanges* ranges, size_t from) {
+    auto count = ranges->Size();
+    if (!NeedsCompaction(ranges->begin(), count, Limits::MAX_RANGES, from)) {
+        return;
     }
-    return newRanges;
+
+    auto data = ranges->MutableData();
+    count = CoalesceRanges(data, count);
+    count = CapRanges(data, count, Limits::MAX_RANGES, IsolateData::Get()->rangeOverflowPolicy);
+    ranges->Truncate(count);
 }
 
 }  //  namespace utils
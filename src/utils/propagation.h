@@ -17,6 +17,12 @@ using tainted::Transaction;
 using tainted::TaintedObject;
 
 SharedRanges* getRangesInSlice(Transaction* transaction, TaintedObject* obj, int sliceStart, int sliceEnd);
+
+// Coalesces the ranges of a propagation result and keeps them under Limits::MAX_RANGES
+// following the overflow policy of the isolate. Ranges shared with an operand must not
+// be passed, they are modified in place. The ones before index from are already compact,
+// which spares a scan of the prefix copied from the first operand of a concat.
+void CompactRanges(SharedRanges* ranges, size_t from = 0);
 }  // namespace utils
 }  // namespace iast
 
@@ -0,0 +1,111 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#ifndef SRC_UTILS_RANGE_COMPACTION_H_
+#define SRC_UTILS_RANGE_COMPACTION_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace iast {
+namespace utils {
+
+// What to do with the ranges of a propagation result that is still over the range
+// limit once adjacent ranges have been coalesced.
+enum class RangeOverflowPolicy {
+    DROP_NEWEST = 0,  // keep the first ranges, the ones past the limit are not propagated
+    DROP_OLDEST,      // keep the last ranges
+    MERGE_SOURCES,    // merge consecutive ranges into as many groups as the limit allows
+    WIDEN,            // widen the last range allowed to cover all the ones after it
+    MAX
+};
+
+// Ranges are sorted by start. A range is coalesced into the previous one when both come
+// from the same input info with the same secure marks and they overlap or touch.
+template<class R>
+bool CanCoalesce(const R& previous, const R& range) noexcept {
+    return range.inputInfoIndex == previous.inputInfoIndex &&
+        range.secureMarks == previous.secureMarks &&
+        range.start >= previous.start &&
+        range.start <= previous.end;
+}
+
+// Ranges before index from are known to be coalesced already.
+template<class R>
+bool NeedsCompaction(const R* ranges, size_t count, size_t maxRanges, size_t from = 0) noexcept {
+    if (count > maxRanges) {
+        return true;
+    }
+    for (size_t i = from > 0 ? from : 1; i < count; i++) {
+        if (CanCoalesce(ranges[i - 1], ranges[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Coalesces ranges in place, returns the number of ranges left.
+template<class R>
+size_t CoalesceRanges(R* ranges, size_t count) noexcept {
+    if (count < 2) {
+        return count;
+    }
+
+    size_t last = 0;
+    for (size_t i = 1; i < count; i++) {
+        if (CanCoalesce(ranges[last], ranges[i])) {
+            ranges[last].end = std::max(ranges[last].end, ranges[i].end);
+        } else {
+            ranges[++last] = ranges[i];
+        }
+    }
+    return last + 1;
+}
+
+// Folds ranges[first, last) into ranges[target]. The result keeps the input info of the
+// first range and only the secure marks shared by all of them.
+template<class R>
+void mergeRanges(R* ranges, size_t first, size_t last, size_t target) noexcept {
+    auto merged = ranges[first];
+    for (size_t i = first + 1; i < last; i++) {
+        merged.end = std::max(merged.end, ranges[i].end);
+        merged.secureMarks &= ranges[i].secureMarks;
+    }
+    ranges[target] = merged;
+}
+
+// Applies the policy in place when there are more than maxRanges ranges, returns the
+// number of ranges left.
+template<class R>
+size_t CapRanges(R* ranges, size_t count, size_t maxRanges, RangeOverflowPolicy policy) noexcept {
+    if (count <= maxRanges) {
+        return count;
+    }
+    if (maxRanges == 0) {
+        return 0;
+    }
+
+    switch (policy) {
+        case RangeOverflowPolicy::DROP_OLDEST:
+            std::copy(ranges + count - maxRanges, ranges + count, ranges);
+            break;
+        case RangeOverflowPolicy::MERGE_SOURCES:
+            // Group g starts at or after index g, so it is read before being overwritten.
+            for (size_t group = 0; group < maxRanges; group++) {
+                mergeRanges(ranges, group * count / maxRanges, (group + 1) * count / maxRanges, group);
+            }
+            break;
+        case RangeOverflowPolicy::WIDEN:
+            mergeRanges(ranges, maxRanges - 1, count, maxRanges - 1);
+            break;
+        default:
+            break;
+    }
+    return maxRanges;
+}
+
+}  // namespace utils
+}  // namespace iast
+#endif  // SRC_UTILS_RANGE_COMPACTION_H_
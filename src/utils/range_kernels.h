@@ -0,0 +1,59 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#ifndef SRC_UTILS_RANGE_KERNELS_H_
+#define SRC_UTILS_RANGE_KERNELS_H_
+
+#include <cstddef>
+
+// Bulk transforms of packed range arrays used by the propagators. A range is 16 bytes
+// with start and end as its first two int32 fields, the other two fields are copied
+// untouched. Lists are capped at Limits::MAX_RANGES, plain loops are as fast as
+// vector instructions at that size.
+namespace iast {
+namespace utils {
+namespace kernels {
+
+template<class R>
+void checkLayout() {
+    static_assert(sizeof(R) == 16, "ranges are packed in 16 bytes");
+    static_assert(offsetof(R, start) == 0 && offsetof(R, end) == 4, "start and end are the first lanes");
+}
+
+// dst[i] = src[i] with offset added to start and end. src and dst may be the same
+// array, but dst must not overlap src otherwise.
+template<class R>
+void ShiftRanges(const R* src, R* dst, size_t count, int offset) noexcept {
+    checkLayout<R>();
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = src[i];
+        dst[i].start += offset;
+        dst[i].end += offset;
+    }
+}
+
+// Copies the ranges overlapping [sliceStart, sliceEnd) to dst, clamped to the slice
+// and relative to its start. src is sorted by start, so the copy stops at the first
+// range starting at or after sliceEnd. dst needs room for count ranges and must not
+// overlap src. Returns the number of ranges copied.
+template<class R>
+size_t SliceRanges(const R* src, R* dst, size_t count, int sliceStart, int sliceEnd) noexcept {
+    checkLayout<R>();
+    size_t copied = 0;
+    for (size_t i = 0; i < count && src[i].start < sliceEnd; i++) {
+        if (src[i].start < sliceStart && src[i].end <= sliceStart) {
+            continue;
+        }
+        dst[copied] = src[i];
+        dst[copied].start = (src[i].start > sliceStart ? src[i].start : sliceStart) - sliceStart;
+        dst[copied].end = (src[i].end < sliceEnd ? src[i].end : sliceEnd) - sliceStart;
+        copied++;
+    }
+    return copied;
+}
+
+}  // namespace kernels
+}  // namespace utils
+}  // namespace iast
+#endif  // SRC_UTILS_RANGE_KERNELS_H_
@@ -6,6 +6,11 @@
 #define SRC_UTILS_STRING_UTILS_H_
 
 #include <node.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <locale>
 #include <codecvt>
@@ -19,11 +24,108 @@ inline uintptr_t GetLocalPointer(v8::Local<v8::Value> val) {
     return *reinterpret_cast<uintptr_t*>(*val);
 }
 
+// With IAST_STABLE_KEYS, two-byte external strings (e.g. the ones made by
+// tainted::NewExternalString) are keyed by their resource, which does not move
+// when the GC moves the string. Everything else is keyed by its heap address.
+inline bool HasStableTaintKey(v8::Local<v8::Value> val) {
+#ifdef IAST_STABLE_KEYS
+    return val->IsString() && v8::String::Cast(*val)->GetExternalStringResource() != nullptr;
+#else
+    return false;
+#endif
+}
+
+inline uintptr_t GetTaintKey(v8::Local<v8::Value> val) {
+#ifdef IAST_STABLE_KEYS
+    if (val->IsString()) {
+        auto resource = v8::String::Cast(*val)->GetExternalStringResource();
+        if (resource != nullptr) {
+            return reinterpret_cast<uintptr_t>(resource);
+        }
+    }
+#endif
+    return GetLocalPointer(val);
+}
+
+const int COERCED_TRUE_LENGTH = 4;
+const int COERCED_FALSE_LENGTH = 5;
+
+inline int GetIntegerStringLength(int64_t value) {
+    int length = value < 0 ? 2 : 1;
+    for (uint64_t rest = value < 0 ? -static_cast<uint64_t>(value) : value; rest >= 10; rest /= 10) {
+        length++;
+    }
+    return length;
+}
+
+// Length of the string Number::toString gives for value, worked out without making it.
+inline int GetNumberStringLength(double value) {
+    if (std::isnan(value)) {
+        return 3;
+    }
+    int sign = value < 0 ? 1 : 0;
+    double abs = std::fabs(value);
+    if (std::isinf(abs)) {
+        return sign + 8;
+    }
+    if (abs == 0) {
+        return 1;
+    }
+    // Integers below 1e21 are written out in full. Powers of ten are exact up to 1e22.
+    if (abs < 1e21 && std::trunc(abs) == abs) {
+        int digits = 1;
+        for (double power = 10; power <= abs; power *= 10) {
+            digits++;
+        }
+        return sign + digits;
+    }
+
+    // k is the smallest number of significant digits that reads back as the same
+    // double and n the position of the decimal point, as in Number::toString.
+    char buffer[32];
+    int k = 1;
+    for (; k <= 17; k++) {
+        snprintf(buffer, sizeof(buffer), "%.*e", k - 1, abs);
+        if (k == 17 || strtod(buffer, nullptr) == abs) {
+            break;
+        }
+    }
+    int n = atoi(strchr(buffer, 'e') + 1) + 1;
+    if (k <= n && n <= 21) {
+        return sign + n;
+    } else if (0 < n && n <= 21) {
+        return sign + k + 1;
+    } else if (-6 < n && n <= 0) {
+        return sign + 2 - n + k;
+    }
+    // d.ddde+x
+    int exponent = std::abs(n - 1);
+    int exponentDigits = exponent >= 100 ? 3 : (exponent >= 10 ? 2 : 1);
+    return sign + k + (k > 1 ? 1 : 0) + 2 + exponentDigits;
+}
+
+// Length of the string a number or a boolean converts to, -1 for any other value.
+inline int GetPrimitiveStringLength(v8::Local<v8::Value> val) {
+    if (val->IsInt32()) {
+        return GetIntegerStringLength(v8::Int32::Cast(*val)->Value());
+    } else if (val->IsNumber()) {
+        return GetNumberStringLength(v8::Number::Cast(*val)->Value());
+    } else if (val->IsBoolean()) {
+        return val->IsTrue() ? COERCED_TRUE_LENGTH : COERCED_FALSE_LENGTH;
+    }
+    return -1;
+}
+
+// Length of the value converted to a string. Numbers and booleans are measured without
+// converting them, other objects are converted, which may run their toString.
 inline int GetCoercedLength(v8::Isolate* isolate, v8::Local<v8::Value> val) {
     if (val->IsString()) {
         return v8::String::Cast(*val)->Length();
     } else {
-        if (val->IsUndefined()) {
+        int primitiveLength = GetPrimitiveStringLength(val);
+        if (primitiveLength >= 0) {
+            return primitiveLength;
+        } else if (val->IsUndefined()) {
             return COERCED_UNDEFINED_LENGTH;
         } else if (val->IsNull()) {
             return COERCED_NULL_LENGTH;
@@ -52,7 +154,10 @@ inline int GetLength(v8::Isolate* isolate, v8::Local<v8::Value> val) {
     } else if (val->IsArrayBufferView()) {
         return v8::ArrayBufferView::Cast(*val)->ByteLength();
     } else {
-        if (val->IsUndefined()) {
+        int primitiveLength = GetPrimitiveStringLength(val);
+        if (primitiveLength >= 0) {
+            return primitiveLength;
+        } else if (val->IsUndefined()) {
             return 0;
         } else if (val->IsNull()) {
             return 0;
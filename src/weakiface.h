@@ -13,8 +13,9 @@ using weak_key_t = uintptr_t;
 
 template <typename T>
 struct WeakObjIface {
-    WeakObjIface<T>* _next = nullptr;
     weak_key_t _key = 0;
+    // Position of the entry in the map that holds it, maintained by the map.
+    uint32_t _index = 0;
 
     bool IsEmpty() { return static_cast<T*>(this)->IsEmpty(); }
     template<class ...Args>
@@ -0,0 +1,92 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <CppUTest/TestHarness.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+#include "weakiface.h"
+#include "container/pool.h"
+#include "container/weakmap.h"
+
+using namespace iast;
+using namespace iast::container;
+
+namespace {
+const size_t USED_ELEMENTS = 64;
+const int ROUNDS = 200;
+const size_t SMALL_CAPACITY = 1 << 10;
+const size_t LARGE_CAPACITY = 1 << 18;
+
+struct BenchRef : public WeakObjIface<BenchRef*> {
+    BenchRef() {}
+    explicit BenchRef(weak_key_t key) { _key = key; }
+    bool IsEmpty() { return false; }
+    weak_key_t Get() { return _key; }
+};
+
+// Best end-of-request time over ROUNDS requests that use USED_ELEMENTS elements each.
+template<size_t N>
+double poolClearNanos() {
+    auto pool = std::make_unique<Pool<BenchRef, N>>();
+    double best = -1;
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < USED_ELEMENTS; i++) {
+            pool->Pop(i);
+        }
+        auto start = std::chrono::steady_clock::now();
+        pool->Clear();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+template<size_t N>
+double weakMapCleanNanos() {
+    auto map = std::make_unique<WeakMap<BenchRef*, N>>();
+    BenchRef refs[USED_ELEMENTS];
+    double best = -1;
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < USED_ELEMENTS; i++) {
+            refs[i]._key = (i + 1) * 8 * 97;
+            map->Insert(refs[i]._key, &refs[i]);
+        }
+        auto start = std::chrono::steady_clock::now();
+        map->Clean();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+}  // namespace
+
+TEST_GROUP(CleanBenchmark)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(CleanBenchmark, pool_clear_by_capacity)
+{
+    auto small = poolClearNanos<SMALL_CAPACITY>();
+    auto large = poolClearNanos<LARGE_CAPACITY>();
+    std::cout << std::endl << "Pool::Clear " << USED_ELEMENTS << " used, capacity " << SMALL_CAPACITY
+        << ": " << small << "ns, capacity " << LARGE_CAPACITY << ": " << large << "ns" << std::endl;
+}
+
+TEST(CleanBenchmark, weakmap_clean_by_capacity)
+{
+    auto small = weakMapCleanNanos<SMALL_CAPACITY>();
+    auto large = weakMapCleanNanos<LARGE_CAPACITY>();
+    std::cout << std::endl << "WeakMap::Clean " << USED_ELEMENTS << " used, capacity " << SMALL_CAPACITY
+        << ": " << small << "ns, capacity " << LARGE_CAPACITY << ": " << large << "ns" << std::endl;
+}
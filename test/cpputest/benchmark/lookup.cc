@@ -0,0 +1,91 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <CppUTest/TestHarness.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+#include "weakiface.h"
+#include "container/weakmap.h"
+
+using namespace iast;
+using namespace iast::container;
+
+namespace {
+const size_t MAP_SIZE = 4096;
+const int ROUNDS = 50;
+// V8 allocates strings next to each other in the heap, so keys share most of their
+// bits and are multiples of the allocation alignment.
+const uintptr_t HEAP_BASE = 0x3a5c00000000;
+const uintptr_t HEAP_STRIDE = 32;
+
+struct BenchRef : public WeakObjIface<BenchRef*> {
+    bool IsEmpty() { return false; }
+    weak_key_t Get() { return _key; }
+};
+
+struct LookupNanos {
+    double hit;
+    double miss;
+};
+
+// Best average time per Find over ROUNDS passes, for present and absent keys.
+LookupNanos lookupNanos(size_t loadPercent) {
+    using Map = WeakMap<BenchRef*, MAP_SIZE>;
+    auto map = std::make_unique<Map>();
+    auto refs = std::make_unique<BenchRef[]>(MAP_SIZE);
+    size_t used = MAP_SIZE * loadPercent / 100;
+
+    // Every other heap slot is tainted, the ones in between are used for misses.
+    for (size_t i = 0; i < used; i++) {
+        map->Insert(HEAP_BASE + 2 * i * HEAP_STRIDE, &refs[i]);
+    }
+
+    LookupNanos best = {-1, -1};
+    size_t found = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < used; i++) {
+            found += map->Find(HEAP_BASE + 2 * i * HEAP_STRIDE) != nullptr;
+        }
+        std::chrono::duration<double, std::nano> hit = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < used; i++) {
+            found += map->Find(HEAP_BASE + (2 * i + 1) * HEAP_STRIDE) != nullptr;
+        }
+        std::chrono::duration<double, std::nano> miss = std::chrono::steady_clock::now() - start;
+
+        if (best.hit < 0 || hit.count() / used < best.hit) {
+            best.hit = hit.count() / used;
+        }
+        if (best.miss < 0 || miss.count() / used < best.miss) {
+            best.miss = miss.count() / used;
+        }
+    }
+    CHECK_EQUAL(used * ROUNDS, found);
+    map->Clean();
+    return best;
+}
+}  // namespace
+
+TEST_GROUP(LookupBenchmark)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(LookupBenchmark, find_latency_by_load)
+{
+    auto low = lookupNanos(10);
+    auto half = lookupNanos(50);
+    auto high = lookupNanos(90);
+    std::cout << std::endl << "WeakMap::Find over " << MAP_SIZE << " entries (hit / miss)"
+        << ": 10% " << low.hit << "ns / " << low.miss << "ns"
+        << ", 50% " << half.hit << "ns / " << half.miss << "ns"
+        << ", 90% " << high.hit << "ns / " << high.miss << "ns" << std::endl;
+}
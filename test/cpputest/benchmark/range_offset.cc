@@ -0,0 +1,98 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <CppUTest/TestHarness.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "iastlimits.h"
+#include "utils/range_kernels.h"
+
+using namespace iast::utils::kernels;
+
+namespace {
+const int ROUNDS = 2000;
+const size_t RANGE_COUNTS[] = {1, 10, iast::Limits::MAX_RANGES};
+
+struct BenchRange {
+    int start;
+    int end;
+    uint32_t inputInfoIndex;
+    uint32_t secureMarks;
+};
+
+std::vector<BenchRange> benchRanges(size_t count) {
+    std::vector<BenchRange> ranges;
+    for (size_t i = 0; i < count; i++) {
+        int start = static_cast<int>(i) * 8;
+        ranges.push_back({start, start + 4, static_cast<uint32_t>(i), 0});
+    }
+    return ranges;
+}
+
+// Best time to shift (concat, join, replace) count ranges over ROUNDS calls.
+template<typename F>
+double shiftNanos(F shift, size_t count) {
+    auto src = benchRanges(count);
+    std::vector<BenchRange> dst(count);
+    double best = -1;
+    for (int round = 0; round < ROUNDS; round++) {
+        auto start = std::chrono::steady_clock::now();
+        shift(src.data(), dst.data(), count, round);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    CHECK_EQUAL(src[count - 1].end + ROUNDS - 1, dst[count - 1].end);
+    return best;
+}
+
+// Best time to slice (substring) the middle half of count ranges over ROUNDS calls.
+template<typename F>
+double sliceNanos(F slice, size_t count) {
+    auto src = benchRanges(count);
+    std::vector<BenchRange> dst(count);
+    int length = src[count - 1].end;
+    double best = -1;
+    size_t copied = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        auto start = std::chrono::steady_clock::now();
+        copied = slice(src.data(), dst.data(), count, length / 4, length - length / 4);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    CHECK(copied <= count);
+    return best;
+}
+}  // namespace
+
+TEST_GROUP(RangeOffsetBenchmark)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(RangeOffsetBenchmark, shift)
+{
+    for (auto count : RANGE_COUNTS) {
+        std::cout << std::endl << "ShiftRanges " << count << " ranges: "
+            << shiftNanos(ShiftRanges<BenchRange>, count) << "ns";
+    }
+    std::cout << std::endl;
+}
+
+TEST(RangeOffsetBenchmark, slice)
+{
+    for (auto count : RANGE_COUNTS) {
+        std::cout << std::endl << "SliceRanges " << count << " ranges: "
+            << sliceNanos(SliceRanges<BenchRange>, count) << "ns";
+    }
+    std::cout << std::endl;
+}
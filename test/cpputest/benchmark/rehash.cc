@@ -0,0 +1,92 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <CppUTest/TestHarness.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "weakiface.h"
+#include "container/weakmap.h"
+
+using namespace iast;
+using namespace iast::container;
+
+namespace {
+const size_t MAP_SIZE = 4096;
+const size_t NEW_PER_SCAVENGE = 128;
+const size_t SCAVENGES = MAP_SIZE / NEW_PER_SCAVENGE;
+const int ROUNDS = 20;
+
+// Emulates a V8 string: it is copied by the first two scavenges it survives
+// (semi-space copy, then promotion) and stays in place afterwards.
+struct MovingRef : public WeakObjIface<MovingRef*> {
+    uintptr_t _address = 0;
+    uintptr_t _resource = 0;
+    int _survived = 0;
+    bool IsEmpty() { return false; }
+    weak_key_t Get() { return _resource ? _resource : _address; }
+};
+
+// Total time spent in Rehash(true) by a scavenge-heavy request: new tainted strings
+// are inserted between scavenges until the map is full.
+double scavengeWorkloadNanos(bool stableKeys) {
+    using Map = WeakMap<MovingRef*, MAP_SIZE>;
+    double best = -1;
+    for (int round = 0; round < ROUNDS; round++) {
+        auto map = std::make_unique<Map>();
+        auto refs = std::make_unique<MovingRef[]>(MAP_SIZE);
+        uintptr_t nextAddress = 8;
+        size_t inserted = 0;
+        double total = 0;
+
+        for (size_t scavenge = 0; scavenge < SCAVENGES; scavenge++) {
+            for (size_t i = 0; i < NEW_PER_SCAVENGE; i++, inserted++) {
+                auto& ref = refs[inserted];
+                ref._address = nextAddress += 8 * 13;
+                if (stableKeys) {
+                    ref._resource = (inserted + 1) * 16;
+                }
+                map->Insert(ref.Get(), &ref, stableKeys);
+            }
+            for (size_t i = 0; i < inserted; i++) {
+                if (refs[i]._survived++ < 2) {
+                    refs[i]._address = nextAddress += 8 * 13;
+                }
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            map->Rehash(true);
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            total += elapsed.count();
+        }
+
+        for (size_t i = 0; i < MAP_SIZE; i++) {
+            CHECK(map->Find(refs[i].Get()) == &refs[i]);
+        }
+        map->Clean();
+        if (best < 0 || total < best) {
+            best = total;
+        }
+    }
+    return best;
+}
+}  // namespace
+
+TEST_GROUP(RehashBenchmark)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(RehashBenchmark, stable_keys_against_pointer_keys)
+{
+    auto pointerKeys = scavengeWorkloadNanos(false);
+    auto stableKeys = scavengeWorkloadNanos(true);
+    std::cout << std::endl << "Rehash over " << SCAVENGES << " scavenges, " << MAP_SIZE
+        << " entries, pointer keys: " << pointerKeys << "ns, stable keys: " << stableKeys << "ns" << std::endl;
+}
@@ -0,0 +1,93 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <CppUTest/TestHarness.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "transaction_manager.h"
+
+using namespace iast;
+
+namespace {
+const int ROUNDS = 20;
+const size_t LOOKUPS = 1 << 16;
+// Transaction ids are pointers to strings allocated next to each other in the heap.
+const uintptr_t HEAP_BASE = 0x1e7a00000000;
+const uintptr_t HEAP_STRIDE = 48;
+
+struct BenchTransaction {
+    uintptr_t _id = 0;
+    BenchTransaction() {}
+    BenchTransaction(uintptr_t id, v8::Local<v8::Value>) : _id(id) {}
+    void Clean() {}
+    void Reinitialize(uintptr_t id, v8::Local<v8::Value>) { _id = id; }
+    void UpdateJsObjectReference(v8::Local<v8::Value>) {}
+};
+
+// Best average time per lookup over ROUNDS passes, where consecutive lookups use the same
+// id `repeat` times in a row before moving to the next live transaction.
+template<typename Lookup>
+double lookupNanos(const std::vector<uintptr_t>& ids, size_t repeat, Lookup lookup) {
+    std::vector<uintptr_t> sequence;
+    for (size_t i = 0; i < LOOKUPS; i++) {
+        sequence.push_back(ids[(i / repeat) % ids.size()]);
+    }
+
+    double best = -1;
+    size_t found = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        auto start = std::chrono::steady_clock::now();
+        for (auto id : sequence) {
+            found += lookup(id) != nullptr;
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        if (best < 0 || elapsed.count() / LOOKUPS < best) {
+            best = elapsed.count() / LOOKUPS;
+        }
+    }
+    CHECK_EQUAL(LOOKUPS * ROUNDS, found);
+    return best;
+}
+}  // namespace
+
+TEST_GROUP(TransactionLookupBenchmark)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(TransactionLookupBenchmark, get_by_live_transactions)
+{
+    v8::Local<v8::Value> jsObject;
+    std::cout << std::endl << "TransactionManager::Get (same request / interleaved / std::map interleaved)";
+    for (size_t count : {1, 16, 256, 4096}) {
+        TransactionManager<BenchTransaction, uintptr_t> manager;
+        std::map<uintptr_t, BenchTransaction*> tree;
+        std::vector<uintptr_t> ids;
+        manager.setMaxItems(count);
+        for (size_t i = 0; i < count; i++) {
+            auto id = HEAP_BASE + i * HEAP_STRIDE;
+            ids.push_back(id);
+            tree[id] = manager.New(id, jsObject);
+        }
+
+        auto get = [&manager](uintptr_t id) { return manager.Get(id); };
+        auto sameRequest = lookupNanos(ids, 32, get);
+        auto interleaved = lookupNanos(ids, 1, get);
+        auto treeInterleaved = lookupNanos(ids, 1, [&tree](uintptr_t id) {
+            auto found = tree.find(id);
+            return found == tree.end() ? nullptr : found->second;
+        });
+        std::cout << std::endl << "    " << count << " live: " << sameRequest << "ns / " << interleaved << "ns / "
+            << treeInterleaved << "ns";
+        manager.Clear();
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,74 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <CppUTest/TestHarness.h>
+#include <cstdint>
+
+#include "container/bloom_filter.h"
+
+using namespace iast::container;
+
+namespace {
+// Keys look like the addresses of strings allocated next to each other in the heap.
+const uintptr_t HEAP_BASE = 0x1e7a00000000;
+const uintptr_t HEAP_STRIDE = 24;
+}  // namespace
+
+TEST_GROUP(BloomFilter)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(BloomFilter, added_keys_are_found)
+{
+    BloomFilter<16> filter(1024);
+    for (uintptr_t i = 0; i < 1024; i++) {
+        filter.Add(HEAP_BASE + i * HEAP_STRIDE);
+    }
+    for (uintptr_t i = 0; i < 1024; i++) {
+        CHECK_TRUE(filter.MayContain(HEAP_BASE + i * HEAP_STRIDE));
+    }
+}
+
+TEST(BloomFilter, false_positive_rate)
+{
+    const uintptr_t keys = 1024;
+    BloomFilter<16> filter(keys);
+    for (uintptr_t i = 0; i < keys; i++) {
+        filter.Add(HEAP_BASE + i * HEAP_STRIDE);
+    }
+
+    size_t falsePositives = 0;
+    const uintptr_t lookups = 100000;
+    for (uintptr_t i = keys; i < keys + lookups; i++) {
+        falsePositives += filter.MayContain(HEAP_BASE + i * HEAP_STRIDE);
+    }
+    // About 0.3% is expected with 16 bits per key.
+    CHECK_TRUE(falsePositives < lookups / 100);
+}
+
+TEST(BloomFilter, clear)
+{
+    BloomFilter<16> filter(64);
+    filter.Add(HEAP_BASE);
+    CHECK_TRUE(filter.MayContain(HEAP_BASE));
+
+    filter.Clear();
+    CHECK_FALSE(filter.MayContain(HEAP_BASE));
+}
+
+TEST(BloomFilter, reset_sizes_the_filter)
+{
+    BloomFilter<16> filter;
+    CHECK_EQUAL(0, filter.GetCapacity());
+    CHECK_EQUAL(BloomFilter<16>::MIN_WORDS * sizeof(uint64_t), filter.GetSizeBytes());
+
+    filter.Add(HEAP_BASE);
+    filter.Reset(4096);
+    CHECK_EQUAL(4096, filter.GetCapacity());
+    CHECK_EQUAL(4096 * 16 / 8, filter.GetSizeBytes());
+    CHECK_FALSE(filter.MayContain(HEAP_BASE));
+}
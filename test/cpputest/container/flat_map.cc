@@ -0,0 +1,111 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <CppUTest/TestHarness.h>
+#include <cstdint>
+#include <map>
+
+#include "container/flat_map.h"
+
+using namespace iast::container;
+
+TEST_GROUP(FlatMap)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(FlatMap, insert_find)
+{
+    FlatMap<uintptr_t, int> map;
+    POINTERS_EQUAL(nullptr, map.Find(1));
+
+    map.Insert(1, 10);
+    map.Insert(2, 20);
+    CHECK_EQUAL(2, map.Size());
+    CHECK_EQUAL(10, *map.Find(1));
+    CHECK_EQUAL(20, *map.Find(2));
+    POINTERS_EQUAL(nullptr, map.Find(3));
+
+    map.Insert(1, 11);
+    CHECK_EQUAL(2, map.Size());
+    CHECK_EQUAL(11, *map.Find(1));
+}
+
+TEST(FlatMap, key_zero)
+{
+    FlatMap<uintptr_t, int> map;
+    POINTERS_EQUAL(nullptr, map.Find(0));
+
+    map.Insert(0, 1);
+    CHECK_EQUAL(1, *map.Find(0));
+    CHECK(map.Erase(0));
+    POINTERS_EQUAL(nullptr, map.Find(0));
+}
+
+TEST(FlatMap, grow_and_erase)
+{
+    FlatMap<uintptr_t, uintptr_t> map;
+    std::map<uintptr_t, uintptr_t> expected;
+    for (uintptr_t i = 1; i <= 1000; i++) {
+        map.Insert(i * 16, i);
+        expected[i * 16] = i;
+    }
+    for (uintptr_t i = 1; i <= 1000; i += 3) {
+        CHECK(map.Erase(i * 16));
+        expected.erase(i * 16);
+    }
+    CHECK_FALSE(map.Erase(16));
+
+    CHECK_EQUAL(expected.size(), map.Size());
+    for (uintptr_t i = 1; i <= 1000; i++) {
+        auto found = map.Find(i * 16);
+        if (expected.count(i * 16)) {
+            CHECK(found != nullptr);
+            CHECK_EQUAL(i, *found);
+        } else {
+            POINTERS_EQUAL(nullptr, found);
+        }
+    }
+
+    size_t visited = 0;
+    map.ForEach([&visited, &expected](uintptr_t key, uintptr_t value) {
+        CHECK_EQUAL(expected[key], value);
+        visited++;
+    });
+    CHECK_EQUAL(expected.size(), visited);
+
+    map.Clear();
+    CHECK_EQUAL(0, map.Size());
+    POINTERS_EQUAL(nullptr, map.Find(32));
+}
+
+TEST(FlatMap, probes_independent_of_size)
+{
+    // Transaction ids are pointers to strings allocated next to each other.
+    const uintptr_t heapBase = 0x1e7a00000000;
+    const uintptr_t heapStride = 48;
+    for (size_t count : {1, 16, 256, 4096, 65536}) {
+        FlatMap<uintptr_t, size_t> map;
+        for (size_t i = 0; i < count; i++) {
+            map.Insert(heapBase + i * heapStride, i);
+        }
+
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t longest = 0;
+        for (size_t i = 0; i < count; i++) {
+            auto hit = map.Probes(heapBase + i * heapStride);
+            auto miss = map.Probes(heapBase + (count + i) * heapStride);
+            hits += hit;
+            misses += miss;
+            longest = hit > longest ? hit : longest;
+            longest = miss > longest ? miss : longest;
+        }
+        CHECK(hits <= 4 * count);
+        CHECK(misses <= 4 * count);
+        CHECK(longest <= 8);
+    }
+}
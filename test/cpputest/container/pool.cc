@@ -7,6 +7,7 @@
 #include <CppUTest/TestFailure.h>
 #include <CppUTest/UtestMacros.h>
 #include <exception>
+#include <stdexcept>
 #include <iostream>
 #include <vector>
 #include <CppUTest/TestHarness.h>
@@ -33,6 +34,14 @@ do { \
 
 using namespace iast::container;
 
+namespace {
+struct CountedElement {
+    static size_t destroyed;
+    ~CountedElement() { destroyed++; }
+};
+size_t CountedElement::destroyed = 0;
+}  // namespace
+
 TEST_GROUP(PoolInitialization)
 {
     void setup() {}
@@ -206,3 +215,191 @@ TEST(Pool, double_clear)
     it = stringPool->begin();
     STRCMP_EQUAL("bar", it->c_str());
 }
+
+TEST_GROUP(ChunkedPool)
+{
+    static const size_t maxElements = 100;
+    static const size_t blockSize = 16;
+    Pool<std::string, maxElements, blockSize>* stringPool;
+
+    void setup() {
+        stringPool = new Pool<std::string, maxElements, blockSize>();
+    }
+    void teardown() {
+        delete stringPool;
+    }
+};
+
+TEST(ChunkedPool, lazy_commit)
+{
+    CHECK_EQUAL(maxElements, stringPool->Capacity());
+    CHECK_EQUAL(0, stringPool->Committed());
+    CHECK_EQUAL(0, stringPool->CommittedBytes());
+    CHECK(stringPool->ReservedBytes() > 0);
+
+    auto str = stringPool->Pop("foo");
+    CHECK_EQUAL(blockSize, stringPool->Committed());
+
+    std::vector<std::string *> stringVector;
+    for (size_t i = 1; i < blockSize + 1; ++i) {
+        stringVector.push_back(stringPool->Pop());
+    }
+    CHECK_EQUAL(2 * blockSize, stringPool->Committed());
+    CHECK(stringPool->CommittedBytes() < stringPool->ReservedBytes());
+
+    stringPool->Push(str);
+    for (auto s : stringVector) {
+        stringPool->Push(s);
+    }
+}
+
+TEST(ChunkedPool, max_elements)
+{
+    std::vector<std::string *> stringVector;
+    for (size_t i = 0; i < maxElements; ++i) {
+        stringVector.push_back(stringPool->Pop());
+    }
+
+    CHECK_EQUAL(stringPool->ReservedBytes(), stringPool->CommittedBytes());
+    CHECK_THROWS(PoolBadAlloc, stringPool->Pop());
+
+    stringPool->Push(stringVector.back());
+    stringVector.pop_back();
+    auto stringPtr = stringPool->Pop();
+    CHECK(stringPtr != nullptr);
+    stringVector.push_back(stringPtr);
+
+    for (auto str : stringVector) {
+        stringPool->Push(str);
+    }
+}
+
+TEST(ChunkedPool, iterate_across_blocks)
+{
+    std::string* ptrs[maxElements] = {};
+    for (size_t i = 0; i < maxElements; ++i) {
+        ptrs[i] = stringPool->Pop(std::to_string(i));
+    }
+
+    for (size_t i = 0; i < maxElements; i += 2) {
+        stringPool->Push(ptrs[i]);
+    }
+
+    auto nElements = 0;
+    for (auto it = stringPool->begin(); it != stringPool->end(); ++it) {
+        nElements++;
+    }
+    CHECK_EQUAL(maxElements / 2, nElements);
+
+    for (size_t i = 1; i < maxElements; i += 2) {
+        stringPool->Push(ptrs[i]);
+    }
+    CHECK(stringPool->begin() == stringPool->end());
+}
+
+TEST(ChunkedPool, clear_releases_blocks)
+{
+    for (size_t i = 0; i < 3 * blockSize; ++i) {
+        stringPool->Pop("foo");
+    }
+    CHECK_EQUAL(3 * blockSize, stringPool->Committed());
+
+    stringPool->Clear();
+    CHECK_EQUAL(blockSize, stringPool->Committed());
+    CHECK(stringPool->begin() == stringPool->end());
+
+    auto ptr = stringPool->Pop("bar");
+    STRCMP_EQUAL("bar", stringPool->begin()->c_str());
+    CHECK_EQUAL(blockSize, stringPool->Committed());
+    stringPool->Push(ptr);
+}
+
+TEST(ChunkedPool, runtime_capacity)
+{
+    std::vector<std::string *> stringVector;
+    stringPool->SetCapacity(maxElements + blockSize);
+    for (size_t i = 0; i < maxElements + blockSize; ++i) {
+        stringVector.push_back(stringPool->Pop());
+    }
+    CHECK_THROWS(PoolBadAlloc, stringPool->Pop());
+
+    stringPool->SetCapacity(blockSize);
+    stringPool->Push(stringVector.back());
+    stringVector.pop_back();
+    CHECK(stringPool->Pop() != nullptr);
+
+    stringPool->Clear();
+    for (size_t i = 0; i < blockSize; ++i) {
+        stringPool->Pop();
+    }
+    CHECK_THROWS(PoolBadAlloc, stringPool->Pop());
+}
+
+TEST(ChunkedPool, push_finds_block_after_clear)
+{
+    std::vector<std::string *> stringVector;
+    for (size_t i = 0; i < 3 * blockSize; ++i) {
+        stringPool->Pop("foo");
+    }
+    stringPool->Clear();
+
+    for (size_t i = 0; i < 4 * blockSize; ++i) {
+        stringVector.push_back(stringPool->Pop(std::to_string(i)));
+    }
+    for (auto str : stringVector) {
+        stringPool->Push(str);
+    }
+    CHECK(stringPool->begin() == stringPool->end());
+
+    // pushed elements are reused from every block
+    for (size_t i = 0; i < 4 * blockSize; ++i) {
+        stringPool->Pop("bar");
+    }
+    CHECK_EQUAL(4 * blockSize, stringPool->Committed());
+    CHECK_EQUAL(4 * blockSize, stringPool->HighWaterMark());
+}
+
+TEST(ChunkedPool, push_foreign_element_is_ignored)
+{
+    auto str = stringPool->Pop("foo");
+    std::string foreign("bar");
+    stringPool->Push(&foreign);
+    STRCMP_EQUAL("foo", stringPool->begin()->c_str());
+    stringPool->Push(str);
+    CHECK(stringPool->begin() == stringPool->end());
+}
+
+TEST(ChunkedPool, pop_throwing_constructor_frees_slot)
+{
+    CHECK_THROWS(std::length_error, stringPool->Pop(std::string::npos, 'a'));
+    CHECK(stringPool->begin() == stringPool->end());
+
+    auto str = stringPool->Pop("foo");
+    CHECK_EQUAL(1, stringPool->HighWaterMark());
+    STRCMP_EQUAL("foo", stringPool->begin()->c_str());
+    stringPool->Push(str);
+}
+
+TEST(ChunkedPool, clear_visits_used_elements)
+{
+    const size_t used = 64;
+    Pool<CountedElement, 1 << 18, blockSize> pool;
+    std::vector<CountedElement*> elements;
+    for (size_t i = 0; i < used; ++i) {
+        elements.push_back(pool.Pop());
+    }
+    for (size_t i = 0; i < used; i += 2) {
+        pool.Push(elements[i]);
+    }
+    for (size_t i = 0; i < used; i += 2) {
+        pool.Pop();
+    }
+
+    // Clear walks up to the high water mark, not the capacity.
+    CHECK_EQUAL(used, pool.HighWaterMark());
+    CHECK_EQUAL(used, pool.Committed());
+    CountedElement::destroyed = 0;
+    pool.Clear();
+    CHECK_EQUAL(used, CountedElement::destroyed);
+    CHECK_EQUAL(0, pool.HighWaterMark());
+}
@@ -0,0 +1,193 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <cstdint>
+#include <CppUTest/TestHarness.h>
+
+#include "container/range_list.h"
+
+using namespace iast::container;
+
+using List = RangeList<int, 2>;
+
+TEST_GROUP(RangeList)
+{
+    void setup() {}
+    void teardown() {}
+
+    void fill(List* list, int count, int first = 0) {
+        for (int i = 0; i < count; i++) {
+            list->PushBack(first + i);
+        }
+    }
+
+    void checkValues(const List& list, int count, int first = 0) {
+        CHECK_EQUAL(count, list.Size());
+        int expected = first;
+        for (auto value : list) {
+            CHECK_EQUAL(expected++, value);
+        }
+    }
+};
+
+TEST(RangeList, inline_storage)
+{
+    List list;
+    CHECK(list.Empty());
+
+    fill(&list, 2);
+    CHECK(list.IsInline());
+    checkValues(list, 2);
+    CHECK_EQUAL(1, list.At(1));
+}
+
+TEST(RangeList, spill_to_heap)
+{
+    List list;
+    fill(&list, 100);
+    CHECK(!list.IsInline());
+    checkValues(list, 100);
+
+    list.Clear();
+    CHECK(list.Empty());
+    CHECK(list.IsInline());
+}
+
+TEST(RangeList, inline_copies_are_independent)
+{
+    List list;
+    fill(&list, 1);
+    List copy(list);
+    copy.PushBack(1);
+
+    checkValues(list, 1);
+    checkValues(copy, 2);
+}
+
+TEST(RangeList, copy_on_write)
+{
+    List list;
+    fill(&list, 10);
+
+    List copy(list);
+    CHECK_EQUAL(2, list.GetRefs());
+    POINTERS_EQUAL(list.begin(), copy.begin());
+
+    copy.MutableData()[0] = 100;
+    CHECK_EQUAL(1, list.GetRefs());
+    CHECK_EQUAL(1, copy.GetRefs());
+    checkValues(list, 10);
+    CHECK_EQUAL(100, copy.At(0));
+}
+
+TEST(RangeList, append_in_place_to_shared_storage)
+{
+    List list;
+    fill(&list, 10);
+
+    List copy(list);
+    copy.PushBack(10);
+    CHECK_EQUAL(2, list.GetRefs());
+    POINTERS_EQUAL(list.begin(), copy.begin());
+    checkValues(list, 10);
+    checkValues(copy, 11);
+
+    // The elements past the end of list are taken, so it gets its own storage.
+    list.PushBack(20);
+    CHECK_EQUAL(1, list.GetRefs());
+    CHECK_EQUAL(1, copy.GetRefs());
+    checkValues(copy, 11);
+    CHECK_EQUAL(20, list.At(10));
+}
+
+TEST(RangeList, concat_chain_shares_storage)
+{
+    List other;
+    fill(&other, 1, 100);
+
+    // 10 elements spill to a block of 16, enough for the chain.
+    List chain;
+    fill(&chain, 10);
+    auto storage = chain.begin();
+    for (int i = 0; i < 5; i++) {
+        List next;
+        next.Append(chain);
+        next.Append(other);
+        chain = next;
+    }
+    POINTERS_EQUAL(storage, chain.begin());
+    CHECK_EQUAL(15, chain.Size());
+    CHECK_EQUAL(100, chain.At(14));
+}
+
+TEST(RangeList, truncated_list_does_not_append_in_place)
+{
+    List list;
+    fill(&list, 10);
+    List copy(list);
+
+    copy.Truncate(5);
+    copy.PushBack(50);
+    CHECK(list.begin() != copy.begin());
+    checkValues(list, 10);
+    CHECK_EQUAL(50, copy.At(5));
+}
+
+TEST(RangeList, assignment_releases_storage)
+{
+    List list;
+    fill(&list, 10);
+    List other;
+    fill(&other, 5, 100);
+
+    List copy(list);
+    copy = other;
+    CHECK_EQUAL(1, list.GetRefs());
+    CHECK_EQUAL(2, other.GetRefs());
+    checkValues(copy, 5, 100);
+
+    copy = copy;
+    CHECK_EQUAL(2, other.GetRefs());
+}
+
+TEST(RangeList, append)
+{
+    List list;
+    fill(&list, 3);
+    List other;
+    fill(&other, 4, 3);
+
+    list.Append(other);
+    checkValues(list, 7);
+    checkValues(other, 4, 3);
+    CHECK_EQUAL(1, other.GetRefs());
+}
+
+TEST(RangeList, append_to_empty_shares)
+{
+    List other;
+    fill(&other, 4);
+
+    List list;
+    list.Append(other);
+    CHECK_EQUAL(2, other.GetRefs());
+    checkValues(list, 4);
+
+    List empty;
+    list.Append(empty);
+    CHECK_EQUAL(2, other.GetRefs());
+}
+
+TEST(RangeList, set_detaches_shared_storage)
+{
+    List list;
+    fill(&list, 10);
+    List copy(list);
+
+    copy.Set(0, 100);
+    CHECK_EQUAL(0, list.At(0));
+    CHECK_EQUAL(100, copy.At(0));
+    CHECK_EQUAL(1, list.GetRefs());
+}
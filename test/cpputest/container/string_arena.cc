@@ -0,0 +1,64 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <CppUTest/TestHarness.h>
+#include <cstdint>
+#include <cstring>
+
+#include "container/string_arena.h"
+
+using namespace iast::container;
+
+TEST_GROUP(StringArena)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(StringArena, allocate_consecutive)
+{
+    StringArena arena;
+    CHECK_EQUAL(0, arena.CommittedBytes());
+
+    auto first = arena.Allocate(3);
+    auto second = arena.Allocate(5);
+    POINTERS_EQUAL(first + 3, second);
+    CHECK_EQUAL(StringArena::CHUNK_UNITS * sizeof(uint16_t), arena.CommittedBytes());
+}
+
+TEST(StringArena, allocate_keeps_previous_strings)
+{
+    StringArena arena;
+    const uint16_t name[] = {'n', 'a', 'm', 'e'};
+    auto first = arena.Allocate(4);
+    memcpy(first, name, sizeof(name));
+
+    for (size_t i = 0; i < StringArena::CHUNK_UNITS; i++) {
+        arena.Allocate(8);
+    }
+    CHECK_EQUAL(0, memcmp(first, name, sizeof(name)));
+    CHECK(arena.CommittedBytes() > StringArena::CHUNK_UNITS * sizeof(uint16_t));
+}
+
+TEST(StringArena, long_strings_get_their_own_chunk)
+{
+    StringArena arena;
+    auto first = arena.Allocate(2);
+    arena.Allocate(StringArena::CHUNK_UNITS);
+    POINTERS_EQUAL(first + 2, arena.Allocate(2));
+}
+
+TEST(StringArena, clear_keeps_first_chunk)
+{
+    StringArena arena;
+    auto first = arena.Allocate(2);
+    for (size_t i = 0; i < StringArena::CHUNK_UNITS; i++) {
+        arena.Allocate(8);
+    }
+
+    arena.Clear();
+    CHECK_EQUAL(StringArena::CHUNK_UNITS * sizeof(uint16_t), arena.CommittedBytes());
+    POINTERS_EQUAL(first, arena.Allocate(2));
+}
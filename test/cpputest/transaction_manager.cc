@@ -175,3 +175,23 @@ TEST(TransactionManager, create_beyond_limit)
     iastManager.Clear();
     CHECK_EQUAL(0, iastManager.Size());
 }
+
+TEST(TransactionManager, get_after_remove)
+{
+    TransactionManager<FakeTransaction, transaction_key_t> iastManager;
+    v8::Local<v8::Value> mockJsObject;
+
+    auto item = iastManager.New(1, mockJsObject);
+    POINTERS_EQUAL(item, iastManager.Get(1));
+    POINTERS_EQUAL(item, iastManager.Get(1));
+
+    iastManager.Remove(1);
+    POINTERS_EQUAL(nullptr, iastManager.Get(1));
+
+    auto item2 = iastManager.New(2, mockJsObject);
+    POINTERS_EQUAL(nullptr, iastManager.Get(1));
+    POINTERS_EQUAL(item2, iastManager.Get(2));
+
+    iastManager.Clear();
+    POINTERS_EQUAL(nullptr, iastManager.Get(2));
+}
@@ -0,0 +1,120 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <cstdint>
+#include <CppUTest/TestHarness.h>
+
+#include "utils/range_compaction.h"
+
+using namespace iast::utils;
+
+namespace {
+struct TestRange {
+    int start;
+    int end;
+    uint32_t inputInfoIndex;
+    uint32_t secureMarks;
+};
+
+// Ranges of length 2 every 3 characters, each from its own input info.
+void fillRanges(TestRange* ranges, size_t count, uint32_t secureMarks) {
+    for (size_t i = 0; i < count; i++) {
+        int start = static_cast<int>(i) * 3;
+        ranges[i] = {start, start + 2, static_cast<uint32_t>(i), secureMarks};
+    }
+}
+}  // namespace
+
+TEST_GROUP(RangeCompaction)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(RangeCompaction, coalesce_adjacent_and_overlapping)
+{
+    TestRange ranges[] = {{0, 2, 1, 0}, {2, 4, 1, 0}, {3, 6, 1, 0}, {4, 5, 1, 0}, {8, 9, 1, 0}};
+    CHECK(NeedsCompaction(ranges, 5, 50));
+    CHECK_EQUAL(2, CoalesceRanges(ranges, 5));
+    CHECK_EQUAL(0, ranges[0].start);
+    CHECK_EQUAL(6, ranges[0].end);
+    CHECK_EQUAL(8, ranges[1].start);
+    CHECK_EQUAL(9, ranges[1].end);
+}
+
+TEST(RangeCompaction, coalesce_keeps_different_sources_and_marks)
+{
+    TestRange ranges[] = {{0, 2, 1, 0}, {2, 4, 2, 0}, {4, 6, 2, 1}, {6, 8, 2, 1}};
+    CHECK_EQUAL(3, CoalesceRanges(ranges, 4));
+    CHECK_EQUAL(1, ranges[0].inputInfoIndex);
+    CHECK_EQUAL(2, ranges[1].inputInfoIndex);
+    CHECK_EQUAL(0, ranges[1].secureMarks);
+    CHECK_EQUAL(4, ranges[2].start);
+    CHECK_EQUAL(8, ranges[2].end);
+    CHECK_EQUAL(1, ranges[2].secureMarks);
+}
+
+TEST(RangeCompaction, nothing_to_compact)
+{
+    TestRange ranges[10];
+    fillRanges(ranges, 10, 0);
+    CHECK_FALSE(NeedsCompaction(ranges, 10, 10));
+    CHECK(NeedsCompaction(ranges, 10, 9));
+    CHECK_EQUAL(10, CapRanges(ranges, 10, 10, RangeOverflowPolicy::DROP_OLDEST));
+    CHECK_EQUAL(0, ranges[0].start);
+}
+
+TEST(RangeCompaction, drop_newest)
+{
+    TestRange ranges[10];
+    fillRanges(ranges, 10, 0);
+    CHECK_EQUAL(4, CapRanges(ranges, 10, 4, RangeOverflowPolicy::DROP_NEWEST));
+    CHECK_EQUAL(0, ranges[0].inputInfoIndex);
+    CHECK_EQUAL(3, ranges[3].inputInfoIndex);
+}
+
+TEST(RangeCompaction, drop_oldest)
+{
+    TestRange ranges[10];
+    fillRanges(ranges, 10, 0);
+    CHECK_EQUAL(4, CapRanges(ranges, 10, 4, RangeOverflowPolicy::DROP_OLDEST));
+    CHECK_EQUAL(6, ranges[0].inputInfoIndex);
+    CHECK_EQUAL(9, ranges[3].inputInfoIndex);
+    CHECK_EQUAL(29, ranges[3].end);
+}
+
+TEST(RangeCompaction, merge_sources)
+{
+    TestRange ranges[10];
+    fillRanges(ranges, 10, 0b11);
+    ranges[3].secureMarks = 0b01;
+    CHECK_EQUAL(4, CapRanges(ranges, 10, 4, RangeOverflowPolicy::MERGE_SOURCES));
+    // Groups of 2, 3, 2 and 3 ranges.
+    CHECK_EQUAL(0, ranges[0].start);
+    CHECK_EQUAL(5, ranges[0].end);
+    CHECK_EQUAL(0b11, ranges[0].secureMarks);
+    CHECK_EQUAL(6, ranges[1].start);
+    CHECK_EQUAL(14, ranges[1].end);
+    CHECK_EQUAL(2, ranges[1].inputInfoIndex);
+    CHECK_EQUAL(0b01, ranges[1].secureMarks);
+    CHECK_EQUAL(15, ranges[2].start);
+    CHECK_EQUAL(20, ranges[2].end);
+    CHECK_EQUAL(21, ranges[3].start);
+    CHECK_EQUAL(29, ranges[3].end);
+}
+
+TEST(RangeCompaction, widen)
+{
+    TestRange ranges[10];
+    fillRanges(ranges, 10, 0b1);
+    ranges[9].secureMarks = 0;
+    CHECK_EQUAL(4, CapRanges(ranges, 10, 4, RangeOverflowPolicy::WIDEN));
+    CHECK_EQUAL(6, ranges[2].start);
+    CHECK_EQUAL(8, ranges[2].end);
+    CHECK_EQUAL(9, ranges[3].start);
+    CHECK_EQUAL(29, ranges[3].end);
+    CHECK_EQUAL(3, ranges[3].inputInfoIndex);
+    CHECK_EQUAL(0, ranges[3].secureMarks);
+}
@@ -0,0 +1,103 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+#include <CppUTest/UtestMacros.h>
+#include <cstdint>
+#include <vector>
+#include <CppUTest/TestHarness.h>
+
+#include "utils/range_kernels.h"
+
+using namespace iast::utils::kernels;
+
+namespace {
+struct TestRange {
+    int start;
+    int end;
+    uint32_t inputInfoIndex;
+    uint32_t secureMarks;
+};
+
+// Sorted ranges of length 3 every 5 characters, the last one overlapping the previous.
+std::vector<TestRange> testRanges(size_t count) {
+    std::vector<TestRange> ranges;
+    for (size_t i = 0; i < count; i++) {
+        int start = static_cast<int>(i) * 5;
+        ranges.push_back({start, start + 3, static_cast<uint32_t>(i), 0xF0000000u | static_cast<uint32_t>(i)});
+    }
+    if (count > 1) {
+        ranges.push_back({ranges.back().start + 1, ranges.back().end + 10, 7, 7});
+    }
+    return ranges;
+}
+
+}  // namespace
+
+TEST_GROUP(RangeKernels)
+{
+    void setup() {}
+    void teardown() {}
+};
+
+TEST(RangeKernels, shift)
+{
+    TestRange src[] = {{1, 4, 7, 8}, {6, 9, 1, 2}};
+    TestRange dst[2];
+    ShiftRanges(src, dst, 2, -1);
+    CHECK_EQUAL(0, dst[0].start);
+    CHECK_EQUAL(3, dst[0].end);
+    CHECK_EQUAL(7, dst[0].inputInfoIndex);
+    CHECK_EQUAL(8, dst[0].secureMarks);
+    CHECK_EQUAL(5, dst[1].start);
+    CHECK_EQUAL(8, dst[1].end);
+}
+
+TEST(RangeKernels, shift_in_place)
+{
+    auto ranges = testRanges(10);
+    auto original = ranges;
+    ShiftRanges(ranges.data(), ranges.data(), ranges.size(), 3);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        CHECK_EQUAL(original[i].start + 3, ranges[i].start);
+        CHECK_EQUAL(original[i].end + 3, ranges[i].end);
+        CHECK_EQUAL(original[i].inputInfoIndex, ranges[i].inputInfoIndex);
+        CHECK_EQUAL(original[i].secureMarks, ranges[i].secureMarks);
+    }
+}
+
+TEST(RangeKernels, slice)
+{
+    TestRange src[] = {{0, 3, 0, 0}, {5, 8, 1, 0}, {10, 20, 2, 0}, {30, 33, 3, 0}};
+    TestRange dst[4];
+    auto copied = SliceRanges(src, dst, 4, 6, 15);
+    CHECK_EQUAL(2, copied);
+    CHECK_EQUAL(0, dst[0].start);
+    CHECK_EQUAL(2, dst[0].end);
+    CHECK_EQUAL(1, dst[0].inputInfoIndex);
+    CHECK_EQUAL(4, dst[1].start);
+    CHECK_EQUAL(9, dst[1].end);
+    CHECK_EQUAL(2, dst[1].inputInfoIndex);
+}
+
+TEST(RangeKernels, slice_between_ranges)
+{
+    auto src = testRanges(20);
+    std::vector<TestRange> dst(src.size());
+    CHECK_EQUAL(0, SliceRanges(src.data(), dst.data(), src.size(), 3, 5));
+    CHECK_EQUAL(0, SliceRanges(src.data(), dst.data(), src.size(), 150, 160));
+}
+
+TEST(RangeKernels, slice_keeps_overlapping_ranges)
+{
+    auto src = testRanges(20);
+    std::vector<TestRange> dst(src.size());
+    auto copied = SliceRanges(src.data(), dst.data(), src.size(), 96, 300);
+    CHECK_EQUAL(2, copied);
+    CHECK_EQUAL(0, dst[0].start);
+    CHECK_EQUAL(2, dst[0].end);
+    CHECK_EQUAL(19, dst[0].inputInfoIndex);
+    CHECK_EQUAL(0, dst[1].start);
+    CHECK_EQUAL(12, dst[1].end);
+    CHECK_EQUAL(7, dst[1].inputInfoIndex);
+}
@@ -63,28 +63,17 @@ TEST(WeakObjIface, Initialization)
     FalseNull falseObj{};
     TrueNotNull trueObj{};
 
-    POINTERS_EQUAL(nullptr, falseObj._next);
+    CHECK_EQUAL(0, falseObj._key);
+    CHECK_EQUAL(0, falseObj._index);
     CHECK_EQUAL(false, falseObj.IsEmpty());
     CHECK_EQUAL(0, falseObj.Get());
 
-    POINTERS_EQUAL(nullptr, trueObj._next);
+    CHECK_EQUAL(0, trueObj._key);
+    CHECK_EQUAL(0, trueObj._index);
     CHECK_EQUAL(true, trueObj.IsEmpty());
     CHECK_EQUAL(1, trueObj.Get());
 }
 
-TEST(WeakObjIface, Next)
-{
-    FalseNull falseObj{};
-    FalseNull falseObj2{};
-
-    POINTERS_EQUAL(nullptr, falseObj._next);
-
-    falseObj._next = &falseObj2;
-    CHECK_EQUAL(&falseObj2, falseObj._next);
-    CHECK_EQUAL(false, falseObj._next->IsEmpty());
-    CHECK_EQUAL(0, falseObj._next->Get());
-}
-
 TEST(WeakObjIface, CheckInterface)
 {
     FalseNull falseObj{};
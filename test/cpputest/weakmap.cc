@@ -26,6 +26,16 @@ class FakeRef : public WeakObjIface<FakeRef*> {
         void* _target;
 };
 
+// Counts how many times the map reads the current key of an entry.
+class CountingRef : public WeakObjIface<CountingRef*> {
+    public:
+        static size_t gets;
+        explicit CountingRef(uintptr_t internal) { _key = internal; }
+        bool IsEmpty() { return false; }
+        weak_key_t Get() { gets++; return _key; }
+};
+size_t CountingRef::gets = 0;
+
 TEST_GROUP(WeakMap)
 {
     void setup() {};
@@ -61,12 +71,28 @@ TEST(WeakMap, insert_beyond_limit)
     ret = wMap.Insert(f->Get(), f);
     CHECK_EQUAL(WEAK_MAP_SUCCESS, ret);
 
-    FakeRef *f2 = new FakeRef(101, 1);
-    ret = wMap.Insert(f->Get(), f2);
+    FakeRef *f2 = new FakeRef(101, 2);
+    ret = wMap.Insert(f2->Get(), f2);
     CHECK_EQUAL(WEAK_MAP_MAX_ELEM, ret);
     delete f2;
 }
 
+TEST(WeakMap, replace_in_full_map)
+{
+    WeakMap<FakeRef*, 1> wMap{};
+    FakeRef *f = new FakeRef(100, 1);
+    FakeRef *f2 = new FakeRef(101, 1);
+    FakeRef *replaced = nullptr;
+
+    CHECK_EQUAL(WEAK_MAP_SUCCESS, wMap.Insert(f->Get(), f, false, &replaced));
+    POINTERS_EQUAL(nullptr, replaced);
+    CHECK_EQUAL(WEAK_MAP_SUCCESS, wMap.Insert(f2->Get(), f2, false, &replaced));
+    POINTERS_EQUAL(f, replaced);
+    CHECK_EQUAL(1, wMap.GetCount());
+    CHECK(wMap.Find(1) == f2);
+    delete f;
+}
+
 TEST(WeakMap, find)
 {
     int ret;
@@ -308,3 +334,310 @@ TEST(WeakMap, clear)
     delete f2;
     delete f3;
 }
+
+TEST(WeakMap, rehash_young_promotes_still_entries)
+{
+    WeakMap<FakeRef*, 10> wMap{};
+    FakeRef *f = new FakeRef(100, 1);
+    FakeRef *f2 = new FakeRef(101, 2);
+
+    wMap.Insert(f->Get(), f);
+    wMap.Insert(f2->Get(), f2);
+    CHECK_EQUAL(2, wMap.GetYoungCount());
+
+    f2->setNewInternal(5);
+    wMap.Rehash(true);
+    CHECK_EQUAL(2, wMap.GetYoungCount());
+    CHECK(wMap.Find(5) == f2);
+
+    for (uint8_t i = 1; i < WeakMap<FakeRef*, 10>::PROMOTION_AGE; i++) {
+        wMap.Rehash(true);
+    }
+    CHECK_EQUAL(1, wMap.GetYoungCount());
+
+    wMap.Rehash(true);
+    CHECK_EQUAL(0, wMap.GetYoungCount());
+    CHECK_EQUAL(2, wMap.GetCount());
+    CHECK(wMap.Find(1) == f);
+    CHECK(wMap.Find(5) == f2);
+}
+
+TEST(WeakMap, rehash_young_skips_old_entries)
+{
+    WeakMap<FakeRef*, 10> wMap{};
+    FakeRef *f = new FakeRef(100, 1);
+
+    wMap.Insert(f->Get(), f);
+    for (uint8_t i = 0; i < WeakMap<FakeRef*, 10>::PROMOTION_AGE; i++) {
+        wMap.Rehash(true);
+    }
+    CHECK_EQUAL(0, wMap.GetYoungCount());
+
+    // old entries only move on a full rehash
+    f->setNewInternal(3);
+    wMap.Rehash(true);
+    CHECK(wMap.Find(3) == nullptr);
+
+    wMap.Rehash();
+    CHECK(wMap.Find(3) == f);
+    CHECK_EQUAL(0, wMap.GetYoungCount());
+}
+
+TEST(WeakMap, find_rekeys_moved_old_entry)
+{
+    WeakMap<FakeRef*, 10> wMap{};
+    FakeRef *f = new FakeRef(100, 1);
+
+    wMap.Insert(f->Get(), f);
+    for (uint8_t i = 0; i < WeakMap<FakeRef*, 10>::PROMOTION_AGE; i++) {
+        wMap.Rehash(true);
+    }
+    CHECK_EQUAL(0, wMap.GetYoungCount());
+
+    // an old entry moved by a scavenge is not taken for a value at its previous address
+    f->setNewInternal(3);
+    wMap.Rehash(true);
+    CHECK(wMap.Find(1) == nullptr);
+    CHECK_EQUAL(1, wMap.GetYoungCount());
+    CHECK(wMap.Find(3) == f);
+
+    wMap.Rehash();
+    CHECK(wMap.Find(1) == nullptr);
+    CHECK(wMap.Find(3) == f);
+    CHECK_EQUAL(1, wMap.GetCount());
+}
+
+TEST(WeakMap, rehash_delete_old_entry)
+{
+    WeakMap<FakeRef*, 10> wMap{};
+    FakeRef *f = new FakeRef(100, 1);
+    FakeRef *f2 = new FakeRef(101, 2);
+    FakeRef *f3 = new FakeRef(102, 3);
+
+    wMap.Insert(f->Get(), f);
+    wMap.Insert(f2->Get(), f2);
+    for (uint8_t i = 0; i < WeakMap<FakeRef*, 10>::PROMOTION_AGE; i++) {
+        wMap.Rehash(true);
+    }
+    wMap.Insert(f3->Get(), f3);
+    CHECK_EQUAL(1, wMap.GetYoungCount());
+
+    f->setNewInternal(0);
+    wMap.Rehash();
+    CHECK_EQUAL(2, wMap.GetCount());
+    CHECK_EQUAL(1, wMap.GetYoungCount());
+    CHECK(wMap.Find(2) == f2);
+    CHECK(wMap.Find(3) == f3);
+
+    wMap.Clean();
+    CHECK(wMap.Find(2) == nullptr);
+    CHECK(wMap.Find(3) == nullptr);
+    delete f;
+    delete f2;
+    delete f3;
+}
+
+TEST(WeakMap, insert_pinned)
+{
+    WeakMap<FakeRef*, 10> wMap{};
+    FakeRef *f = new FakeRef(100, 1);
+    FakeRef *f2 = new FakeRef(101, 2);
+
+    wMap.Insert(f->Get(), f);
+    wMap.Insert(f2->Get(), f2, true);
+    CHECK_EQUAL(2, wMap.GetCount());
+    CHECK_EQUAL(1, wMap.GetYoungCount());
+
+    f->setNewInternal(3);
+    wMap.Rehash(true);
+    CHECK(wMap.Find(3) == f);
+    CHECK(wMap.Find(2) == f2);
+}
+
+TEST(WeakMap, for_each_key)
+{
+    WeakMap<FakeRef*, 10> wMap{};
+    FakeRef *f = new FakeRef(100, 1);
+    FakeRef *f2 = new FakeRef(101, 2);
+
+    wMap.Insert(f->Get(), f);
+    wMap.Insert(f2->Get(), f2, true);
+    f->setNewInternal(3);
+    wMap.Rehash(true);
+
+    weak_key_t sum = 0;
+    wMap.ForEachKey([&sum](weak_key_t key) { sum += key; });
+    CHECK_EQUAL(5, sum);
+
+    sum = 0;
+    wMap.ForEachKey([&sum](weak_key_t key) { sum += key; }, true);
+    CHECK_EQUAL(3, sum);
+}
+
+TEST(WeakMap, insert_existing_key_replaces)
+{
+    WeakMap<FakeRef*, 10> wMap{};
+    FakeRef *f = new FakeRef(100, 1);
+    FakeRef *f2 = new FakeRef(101, 1);
+
+    wMap.Insert(f->Get(), f);
+    wMap.Insert(f2->Get(), f2);
+    CHECK_EQUAL(1, wMap.GetCount());
+    CHECK(wMap.Find(1) == f2);
+
+    wMap.Clean();
+    delete f;
+    delete f2;
+}
+
+TEST(WeakMap, delete_keeps_probed_entries)
+{
+    const int count = 64;
+    WeakMap<FakeRef*, count> wMap{};
+    FakeRef* refs[count];
+
+    for (int i = 0; i < count; i++) {
+        refs[i] = new FakeRef(i, (i + 1) * 16);
+        CHECK_EQUAL(WEAK_MAP_SUCCESS, wMap.Insert(refs[i]->Get(), refs[i]));
+    }
+    for (int i = 0; i < count; i += 2) {
+        wMap.Del(refs[i]->Get());
+    }
+
+    CHECK_EQUAL(count / 2, wMap.GetCount());
+    for (int i = 0; i < count; i++) {
+        FakeRef* expected = (i % 2) ? refs[i] : nullptr;
+        CHECK(wMap.Find((i + 1) * 16) == expected);
+    }
+}
+
+TEST(WeakMap, rehash_swapped_keys)
+{
+    WeakMap<FakeRef*, 10> wMap{};
+    FakeRef *f = new FakeRef(100, 1);
+    FakeRef *f2 = new FakeRef(101, 2);
+
+    wMap.Insert(f->Get(), f);
+    wMap.Insert(f2->Get(), f2);
+
+    f->setNewInternal(2);
+    f2->setNewInternal(1);
+    wMap.Rehash(true);
+    CHECK_EQUAL(2, wMap.GetCount());
+    CHECK(wMap.Find(1) == f2);
+    CHECK(wMap.Find(2) == f);
+}
+
+TEST(WeakMap, grow_up_to_max_elements)
+{
+    const int count = 200;
+    WeakMap<FakeRef*, count> wMap{};
+    FakeRef* refs[count];
+    CHECK_EQUAL(64, wMap.GetCapacity());
+
+    for (int i = 0; i < count; i++) {
+        refs[i] = new FakeRef(i, (i + 1) * 16);
+        CHECK_EQUAL(WEAK_MAP_SUCCESS, wMap.Insert(refs[i]->Get(), refs[i]));
+    }
+    CHECK_EQUAL(count, wMap.GetCapacity());
+    for (int i = 0; i < count; i++) {
+        CHECK(wMap.Find((i + 1) * 16) == refs[i]);
+    }
+
+    FakeRef *extra = new FakeRef(count, 1);
+    CHECK_EQUAL(WEAK_MAP_MAX_ELEM, wMap.Insert(extra->Get(), extra));
+
+    wMap.SetMaxElements(count + 1);
+    CHECK_EQUAL(WEAK_MAP_SUCCESS, wMap.Insert(extra->Get(), extra));
+    CHECK(wMap.Find(1) == extra);
+
+    wMap.Clean();
+    CHECK_EQUAL(64, wMap.GetCapacity());
+    CHECK(wMap.Find(16) == nullptr);
+    for (int i = 0; i < count; i++) {
+        delete refs[i];
+    }
+    delete extra;
+}
+
+TEST(WeakMap, clean_visits_used_entries)
+{
+    const int count = 64;
+    WeakMap<FakeRef*, 1 << 18> wMap{};
+    FakeRef* refs[count + 1];
+
+    for (int i = 0; i <= count; i++) {
+        refs[i] = new FakeRef(i, (i + 1) * 16);
+    }
+
+    // The table Clean wipes is sized by the entries in use, not by the maximum.
+    for (int i = 0; i < count; i++) {
+        CHECK_EQUAL(WEAK_MAP_SUCCESS, wMap.Insert(refs[i]->Get(), refs[i]));
+    }
+    CHECK_EQUAL(count, wMap.GetCapacity());
+    wMap.Clean();
+    CHECK_EQUAL(0, wMap.GetCount());
+    CHECK(wMap.Find(16) == nullptr);
+
+    for (int i = 0; i <= count; i++) {
+        CHECK_EQUAL(WEAK_MAP_SUCCESS, wMap.Insert(refs[i]->Get(), refs[i]));
+    }
+    CHECK_EQUAL(2 * count, wMap.GetCapacity());
+    wMap.Clean();
+    CHECK_EQUAL(count, wMap.GetCapacity());
+    for (int i = 0; i <= count; i++) {
+        CHECK(wMap.Find((i + 1) * 16) == nullptr);
+        delete refs[i];
+    }
+}
+
+TEST(WeakMap, rehash_young_skips_pinned_entries)
+{
+    const int count = 128;
+    using Map = WeakMap<CountingRef*, count>;
+    Map wMap{};
+
+    // Pinned entries are never read by a scavenge, unpinned ones until they are old.
+    for (int i = 0; i < count; i++) {
+        CHECK_EQUAL(WEAK_MAP_SUCCESS, wMap.Insert((i + 1) * 16, new CountingRef((i + 1) * 16), i % 2 == 0));
+    }
+    CountingRef::gets = 0;
+    for (int scavenge = 0; scavenge < 4; scavenge++) {
+        wMap.Rehash(true);
+    }
+    CHECK_EQUAL(count / 2 * Map::PROMOTION_AGE, CountingRef::gets);
+    CHECK_EQUAL(0, wMap.GetYoungCount());
+
+    CountingRef::gets = 0;
+    wMap.Rehash(true);
+    CHECK_EQUAL(0, CountingRef::gets);
+}
+
+TEST(WeakMap, probes_stay_short_when_full)
+{
+    const size_t count = 4096;
+    const uintptr_t heapBase = 0x3a5c00000000;
+    const uintptr_t heapStride = 32;
+    WeakMap<FakeRef*, count> wMap{};
+
+    // Keys are aligned heap addresses next to each other, every other one is tainted.
+    for (size_t i = 0; i < count; i++) {
+        auto key = heapBase + 2 * i * heapStride;
+        CHECK_EQUAL(WEAK_MAP_SUCCESS, wMap.Insert(key, new FakeRef(i, key)));
+    }
+
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t longest = 0;
+    for (size_t i = 0; i < count; i++) {
+        auto hit = wMap.GetProbes(heapBase + 2 * i * heapStride);
+        auto miss = wMap.GetProbes(heapBase + (2 * i + 1) * heapStride);
+        hits += hit;
+        misses += miss;
+        longest = hit > longest ? hit : longest;
+        longest = miss > longest ? miss : longest;
+    }
+    CHECK(hits <= 2 * count);
+    CHECK(misses <= 4 * count);
+    CHECK(longest <= 8);
+}
@@ -245,3 +245,285 @@ describe('concat method', () => {
     })
   })
 })
+
+describe('Range compaction', () => {
+  const id = TaintedUtils.createTransaction('1')
+  const MAX_RANGES = 50
+
+  afterEach(function () {
+    TaintedUtils.setRangeOverflowPolicy(0)
+    TaintedUtils.removeTransaction(id)
+  })
+
+  function concatSources (count) {
+    const operands = []
+    for (let i = 0; i < count; i++) {
+      operands.push(TaintedUtils.newTaintedString(id, `value${i}-`, 'param', 'REQUEST'))
+    }
+    const res = operands.join('')
+    return { operands, ret: TaintedUtils.concat(id, res, ...operands) }
+  }
+
+  it('Adjacent ranges from the same input info are coalesced', () => {
+    const tainted = TaintedUtils.newTaintedString(id, 'hello world', 'param', 'REQUEST')
+    const op1 = TaintedUtils.substring(id, tainted.substring(0, 5), tainted, 0, 5)
+    const op2 = TaintedUtils.substring(id, tainted.substring(5), tainted, 5)
+    const ret = TaintedUtils.concat(id, op1 + op2 + '!', op1, op2, '!')
+
+    assert.equal(formatTaintedValue(id, ret), ':+-hello world-+:!')
+  })
+
+  it('Ranges with different secure marks are not coalesced', () => {
+    const tainted = TaintedUtils.newTaintedString(id, 'hello world', 'param', 'REQUEST')
+    const op1 = TaintedUtils.substring(id, tainted.substring(0, 5), tainted, 0, 5)
+    const op2 = TaintedUtils.addSecureMarksToTaintedString(id,
+      TaintedUtils.substring(id, tainted.substring(5), tainted, 5), 0b0001)
+    const ret = TaintedUtils.concat(id, op1 + op2, op1, op2)
+
+    assert.equal(formatTaintedValue(id, ret), ':+-hello-+::+- world-+:')
+  })
+
+  it('Drops the newest ranges over the limit by default', () => {
+    const { operands, ret } = concatSources(MAX_RANGES + 10)
+    const ranges = TaintedUtils.getRanges(id, ret)
+
+    assert.equal(ranges.length, MAX_RANGES)
+    assert.equal(ranges[0].iinfo.parameterValue, operands[0])
+    assert.equal(ranges[MAX_RANGES - 1].iinfo.parameterValue, operands[MAX_RANGES - 1])
+  })
+
+  it('Drops the oldest ranges over the limit', () => {
+    TaintedUtils.setRangeOverflowPolicy(1)
+    const { operands, ret } = concatSources(MAX_RANGES + 10)
+    const ranges = TaintedUtils.getRanges(id, ret)
+
+    assert.equal(ranges.length, MAX_RANGES)
+    assert.equal(ranges[0].iinfo.parameterValue, operands[10])
+    assert.equal(ranges[MAX_RANGES - 1].end, ret.length)
+  })
+
+  it('Merges ranges from different sources over the limit', () => {
+    TaintedUtils.setRangeOverflowPolicy(2)
+    const { ret } = concatSources(MAX_RANGES * 2)
+    const ranges = TaintedUtils.getRanges(id, ret)
+
+    assert.equal(ranges.length, MAX_RANGES)
+    assert.equal(ranges[0].start, 0)
+    assert.equal(ranges[0].end, ranges[1].start)
+    assert.equal(ranges[MAX_RANGES - 1].end, ret.length)
+  })
+
+  it('Widens the last range over the limit', () => {
+    TaintedUtils.setRangeOverflowPolicy(3)
+    const { operands, ret } = concatSources(MAX_RANGES + 10)
+    const ranges = TaintedUtils.getRanges(id, ret)
+
+    assert.equal(ranges.length, MAX_RANGES)
+    assert.equal(ranges[MAX_RANGES - 2].iinfo.parameterValue, operands[MAX_RANGES - 2])
+    assert.equal(ranges[MAX_RANGES - 1].iinfo.parameterValue, operands[MAX_RANGES - 1])
+    assert.equal(ranges[MAX_RANGES - 1].end, ret.length)
+  })
+
+  it('Ignores unknown policies', () => {
+    TaintedUtils.setRangeOverflowPolicy(1)
+    TaintedUtils.setRangeOverflowPolicy(4)
+    const { operands, ret } = concatSources(MAX_RANGES + 10)
+
+    assert.equal(TaintedUtils.getRanges(id, ret)[0].iinfo.parameterValue, operands[10])
+  })
+})
+
+describe('Concat chains', () => {
+  const id = TaintedUtils.createTransaction('1')
+
+  afterEach(function () {
+    TaintedUtils.removeTransaction(id)
+  })
+
+  function taint (value) {
+    return TaintedUtils.newTaintedString(id, value, 'param', 'REQUEST')
+  }
+
+  it('Keeps the ranges of every step of a += chain', () => {
+    let chain = ''
+    const values = []
+    for (let i = 0; i < 40; i++) {
+      const value = taint(`value${i}`)
+      values.push(value)
+      chain = TaintedUtils.concat(id, chain + value + ',', chain, value, ',')
+    }
+
+    const ranges = TaintedUtils.getRanges(id, chain)
+    assert.equal(ranges.length, values.length)
+    ranges.forEach((range, i) => {
+      assert.equal(chain.substring(range.start, range.end), values[i])
+    })
+  })
+
+  it('Branches of a chain do not see each other ranges', () => {
+    let base = ''
+    for (let i = 0; i < 5; i++) {
+      const value = taint(`base${i}`)
+      base = TaintedUtils.concat(id, base + value, base, value)
+    }
+    const leftValue = taint('left')
+    const rightValue = taint('right')
+    const left = TaintedUtils.concat(id, base + '|' + leftValue, base, '|', leftValue)
+    const right = TaintedUtils.concat(id, base + rightValue, base, rightValue)
+
+    assert.equal(formatTaintedValue(id, base),
+      ':+-base0-+::+-base1-+::+-base2-+::+-base3-+::+-base4-+:')
+    assert.equal(formatTaintedValue(id, left),
+      ':+-base0-+::+-base1-+::+-base2-+::+-base3-+::+-base4-+:|:+-left-+:')
+    assert.equal(formatTaintedValue(id, right),
+      ':+-base0-+::+-base1-+::+-base2-+::+-base3-+::+-base4-+::+-right-+:')
+  })
+})
+
+describe('Concat operand lengths', () => {
+  const id = TaintedUtils.createTransaction('1')
+
+  afterEach(function () {
+    TaintedUtils.removeTransaction(id)
+  })
+
+  function taint (value) {
+    return TaintedUtils.newTaintedString(id, value, 'param', 'REQUEST')
+  }
+
+  const primitives = [0, -0, 7, -42, 2 ** 31, 1.5, -1 / 3, 1e21, 123456789012345680000, 1.5e-7, 0.000001,
+    5e-324, NaN, Infinity, -Infinity, Date.now() + 0.25, true, false, null, undefined]
+
+  primitives.forEach(value => {
+    it(`Ranges after ${value}`, () => {
+      const tainted = taint('tainted')
+      const res = 'a' + value + tainted
+      const ret = TaintedUtils.concat(id, res, 'a', value, tainted)
+      assert.equal(formatTaintedValue(id, ret), `a${value}:+-tainted-+:`)
+    })
+  })
+
+  it('Objects are only converted when a tainted operand follows them', () => {
+    let calls = 0
+    const obj = { toString () { calls++; return 'obj' } }
+    const tainted = taint('tainted')
+
+    TaintedUtils.concat(id, tainted + 'obj', tainted, obj)
+    assert.equal(calls, 0)
+
+    const ret = TaintedUtils.concat(id, 'obj' + tainted, obj, tainted)
+    assert.equal(calls, 1)
+    assert.equal(formatTaintedValue(id, ret), 'obj:+-tainted-+:')
+  })
+
+  it('Wrong arguments', () => {
+    assert.throws(() => TaintedUtils.concatWithLengths(id, 'a', [1]), TypeError)
+  })
+
+  it('Uses the lengths passed instead of converting the operands', () => {
+    let calls = 0
+    const obj = { toString () { calls++; return 'obj' } }
+    const tainted = taint('tainted')
+    const res = 'obj-' + tainted + 'obj' + tainted
+
+    const lengths = [
+      new Int32Array([3, 1, 7, 3, 7]),
+      new Uint32Array([3, 1, 7, 3, 7]),
+      [3, 1, 7, 3, 7]
+    ]
+    lengths.forEach(operandLengths => {
+      const ret = TaintedUtils.concatWithLengths(id, res, operandLengths, obj, '-', tainted, obj, tainted)
+      assert.equal(formatTaintedValue(id, ret), 'obj-:+-tainted-+:obj:+-tainted-+:')
+    })
+    assert.equal(calls, 0)
+  })
+
+  it('Derives missing lengths from the operands', () => {
+    const tainted = taint('tainted')
+    const res = 'ab' + 12.5 + tainted
+
+    const ret = TaintedUtils.concatWithLengths(id, res, [2], 'ab', 12.5, tainted)
+    assert.equal(formatTaintedValue(id, ret), 'ab12.5:+-tainted-+:')
+
+    const other = TaintedUtils.concatWithLengths(id, res, null, 'ab', 12.5, tainted)
+    assert.equal(formatTaintedValue(id, other), 'ab12.5:+-tainted-+:')
+  })
+})
+
+describe('Concat operand offsets', () => {
+  const id = TaintedUtils.createTransaction('1')
+
+  afterEach(function () {
+    TaintedUtils.removeTransaction(id)
+  })
+
+  function taint (value) {
+    return TaintedUtils.newTaintedString(id, value, 'param', 'REQUEST')
+  }
+
+  it('Wrong arguments', () => {
+    assert.throws(() => TaintedUtils.concatWithOffsets(id, 'a'), TypeError)
+  })
+
+  it('Uses the offsets passed instead of converting the operands', () => {
+    let calls = 0
+    const obj = { toString () { calls++; return 'obj' } }
+    const tainted = taint('tainted')
+    const res = 'obj-' + tainted + 'obj' + tainted
+
+    const offsets = [
+      new Int32Array([0, 3, 4, 11, 14]),
+      new Uint32Array([0, 3, 4, 11, 14]),
+      [0, 3, 4, 11, 14]
+    ]
+    offsets.forEach(operandOffsets => {
+      const ret = TaintedUtils.concatWithOffsets(id, res, [obj, '-', tainted, obj, tainted], operandOffsets)
+      assert.equal(formatTaintedValue(id, ret), 'obj-:+-tainted-+:obj:+-tainted-+:')
+    })
+    assert.equal(calls, 0)
+  })
+
+  it('Derives missing offsets from the operands', () => {
+    const tainted = taint('tainted')
+    const res = 'ab' + 12.5 + tainted + tainted
+
+    const ret = TaintedUtils.concatWithOffsets(id, res, ['ab', 12.5, tainted, tainted])
+    assert.equal(formatTaintedValue(id, ret), 'ab12.5:+-taintedtainted-+:')
+
+    const other = TaintedUtils.concatWithOffsets(id, res, ['ab', 12.5, tainted, tainted], [0, 2, -1])
+    assert.equal(formatTaintedValue(id, other), 'ab12.5:+-taintedtainted-+:')
+  })
+
+  it('Uses the offset passed for the first operand', () => {
+    const tainted = taint('tainted')
+    const res = 'xx' + tainted
+
+    const ret = TaintedUtils.concatWithOffsets(id, res, [tainted], [2])
+    assert.equal(formatTaintedValue(id, ret), 'xx:+-tainted-+:')
+  })
+
+  it('Clamps the ranges to the result when the offsets go past it', () => {
+    const tainted = taint('tainted')
+    const res = tainted + tainted
+
+    const ret = TaintedUtils.concatWithOffsets(id, res, [tainted, tainted], [0, 1000])
+    assert.equal(formatTaintedValue(id, ret), ':+-tainted-+:tainted')
+
+    const partial = TaintedUtils.concatWithOffsets(id, res, [tainted, tainted], [10, 12])
+    assert.equal(formatTaintedValue(id, partial), 'taintedtai:+-nted-+:')
+    TaintedUtils.getRanges(id, partial).forEach(range => assert.ok(range.end <= res.length))
+  })
+
+  it('Untainted operands return an untainted result', () => {
+    const res = 'abc' + 'def'
+    const ret = TaintedUtils.concatWithOffsets(id, res, ['abc', 'def'], [0, 3])
+    assert.equal(ret, res)
+    assert.equal(TaintedUtils.isTainted(id, ret), false)
+  })
+
+  it('Operands that are not in an array are ignored', () => {
+    const tainted = taint('tainted')
+    const ret = TaintedUtils.concatWithOffsets(id, 'a' + tainted, 'a', tainted)
+    assert.equal(TaintedUtils.isTainted(id, ret), false)
+  })
+})
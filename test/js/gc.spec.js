@@ -0,0 +1,91 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+
+'use strict'
+
+const { TaintedUtils } = require('./util')
+const assert = require('assert')
+const v8 = require('v8')
+const vm = require('vm')
+
+v8.setFlagsFromString('--expose-gc')
+const gc = vm.runInNewContext('gc')
+
+describe('GC', function () {
+  const id = TaintedUtils.createTransaction('1')
+
+  afterEach(function () {
+    TaintedUtils.removeTransaction(id)
+  })
+
+  it('Tainted values survive scavenges', function () {
+    const values = []
+    for (let i = 0; i < 100; i++) {
+      values.push(TaintedUtils.newTaintedString(id, `value-${i}`, 'param', 'request'))
+    }
+
+    for (let i = 0; i < 4; i++) {
+      gc({ type: 'minor' })
+      values.forEach(value => assert.strictEqual(true, TaintedUtils.isTainted(id, value), 'Value expected tainted'))
+    }
+  })
+
+  it('Tainted values survive mark sweep compact', function () {
+    const values = []
+    for (let i = 0; i < 100; i++) {
+      values.push(TaintedUtils.newTaintedString(id, `value-${i}`, 'param', 'request'))
+    }
+
+    gc({ type: 'minor' })
+    gc()
+    values.forEach(value => assert.strictEqual(true, TaintedUtils.isTainted(id, value), 'Value expected tainted'))
+  })
+
+  it('One char values stay tainted when their resources are reused', function () {
+    const chars = ['a', 'ü', '佫', '\uD83D']
+    let values = []
+    for (let i = 0; i < 200; i++) {
+      values.push(TaintedUtils.newTaintedString(id, chars[i % chars.length], 'param', 'request'))
+    }
+    values = null
+    gc()
+
+    const reused = []
+    for (let i = 0; i < 200; i++) {
+      const value = TaintedUtils.newTaintedString(id, chars[i % chars.length], 'param', 'request')
+      reused.push(TaintedUtils.slice(id, value.slice(0, 1), value, 0, 1))
+    }
+    reused.forEach((value, i) => {
+      assert.strictEqual(value, chars[i % chars.length])
+      assert.strictEqual(true, TaintedUtils.isTainted(id, value), 'Value expected tainted')
+    })
+  })
+
+  it('Rehash metrics are updated on every GC', function () {
+    TaintedUtils.newTaintedString(id, 'value', 'param', 'request')
+    const before = TaintedUtils.getRehashMetrics()
+
+    gc({ type: 'minor' })
+    gc()
+
+    const after = TaintedUtils.getRehashMetrics()
+    assert.ok(after.scavenge.count > before.scavenge.count, 'Scavenge count expected to increase')
+    assert.ok(after.markSweepCompact.count > before.markSweepCompact.count, 'Mark sweep count expected to increase')
+    assert.ok(after.scavenge.totalNanos >= before.scavenge.totalNanos, 'Scavenge time expected to increase')
+    assert.ok(after.markSweepCompact.maxNanos >= after.markSweepCompact.lastNanos, 'Max expected to be the biggest')
+  })
+
+  it('Transaction handles survive GCs', function () {
+    const handle = TaintedUtils.createTransaction('2', true)
+    const value = TaintedUtils.newTaintedString(handle, 'value', 'param', 'request')
+
+    gc({ type: 'minor' })
+    gc()
+    assert.strictEqual(true, TaintedUtils.isTainted(handle, value), 'Value expected tainted')
+
+    TaintedUtils.removeTransaction(handle)
+    assert.strictEqual(false, TaintedUtils.isTainted(handle, value), 'Value expected not tainted')
+  })
+})
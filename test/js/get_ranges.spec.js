@@ -42,4 +42,42 @@ describe('Ranges', function () {
     const ranges = TaintedUtils.getRanges(id, nonTainted)
     assert.equal(ranges, undefined, 'Ranges expected to be equal')
   })
+
+  describe('Packed', function () {
+    it('Get packed ranges', function () {
+      const taintedValue = TaintedUtils.newTaintedString(id, value, param, 'REQUEST')
+
+      const packed = TaintedUtils.getRangesPacked(id, taintedValue)
+      assert.ok(packed.ranges instanceof Uint32Array)
+      assert.deepEqual(Array.from(packed.ranges), [0, value.length, 0, 0])
+      assert.deepEqual(packed.inputInfos, [{ parameterName: 'param', parameterValue: 'test', type: 'REQUEST' }])
+    })
+
+    it('Share input infos between ranges', function () {
+      const taintedValue = TaintedUtils.newTaintedString(id, value, param, 'REQUEST')
+      const other = TaintedUtils.newTaintedString(id, 'other', 'param2', 'REQUEST')
+      let result = TaintedUtils.concat(id, taintedValue + '-' + other, taintedValue, '-', other)
+      result = TaintedUtils.concat(id, result + taintedValue, result, taintedValue)
+
+      const packed = TaintedUtils.getRangesPacked(id, result)
+      const ranges = TaintedUtils.getRanges(id, result)
+      assert.strictEqual(packed.ranges.length, ranges.length * 4)
+      assert.strictEqual(packed.inputInfos.length, 2)
+      ranges.forEach((range, i) => {
+        assert.strictEqual(packed.ranges[i * 4], range.start)
+        assert.strictEqual(packed.ranges[i * 4 + 1], range.end)
+        assert.strictEqual(packed.ranges[i * 4 + 2], range.secureMarks)
+        assert.strictEqual(packed.inputInfos[packed.ranges[i * 4 + 3]], range.iinfo)
+      })
+    })
+
+    it('Get packed ranges from non tainted string', function () {
+      TaintedUtils.newTaintedString(id, value, param, 'REQUEST')
+      assert.strictEqual(TaintedUtils.getRangesPacked(id, 'value'), null)
+    })
+
+    it('Wrong number of arguments', function () {
+      assert.throws(function () { TaintedUtils.getRangesPacked(id) }, Error)
+    })
+  })
 })
@@ -0,0 +1,105 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+const { TaintedUtils } = require('./util')
+const assert = require('assert')
+
+describe('Batched isTainted', function () {
+  const id = TaintedUtils.createTransaction('1')
+
+  afterEach(function () {
+    TaintedUtils.removeTransaction(id)
+  })
+
+  function taint (value) {
+    return TaintedUtils.newTaintedString(id, value, 'param', 'REQUEST')
+  }
+
+  it('Wrong number of arguments', function () {
+    assert.throws(() => TaintedUtils.isTaintedBatch(id), TypeError)
+  })
+
+  it('Not an object returns null', function () {
+    assert.strictEqual(TaintedUtils.isTaintedBatch(id, 'value'), null)
+  })
+
+  it('Unknown transaction returns no indices', function () {
+    const ret = TaintedUtils.isTaintedBatch('unknown', [taint('tainted value')])
+    assert.deepStrictEqual(Array.from(ret), [])
+  })
+
+  it('Array returns tainted indices', function () {
+    const values = ['not tainted', taint('tainted value 1'), 3, null, taint('tainted value 2')]
+    const ret = TaintedUtils.isTaintedBatch(id, values)
+    assert.ok(ret instanceof Uint32Array)
+    assert.deepStrictEqual(Array.from(ret), [1, 4])
+  })
+
+  it('Array returns bitmap', function () {
+    const values = new Array(10).fill('not tainted')
+    values[0] = taint('tainted value 1')
+    values[9] = taint('tainted value 2')
+    const ret = TaintedUtils.isTaintedBatch(id, values, 0, true)
+    assert.ok(ret instanceof Uint8Array)
+    assert.deepStrictEqual(Array.from(ret), [0b00000001, 0b00000010])
+  })
+
+  it('Object returns indices of its keys', function () {
+    const values = { a: 'not tainted', b: taint('tainted value 1'), c: taint('tainted value 2') }
+    const ret = TaintedUtils.isTaintedBatch(id, values)
+    const keys = Object.keys(values)
+    assert.deepStrictEqual(Array.from(ret).map(i => keys[i]), ['b', 'c'])
+  })
+
+  it('Nested values are only checked up to maxDepth', function () {
+    const values = [{ a: { b: taint('tainted value 1') } }, ['not tainted', [taint('tainted value 2')]]]
+    assert.deepStrictEqual(Array.from(TaintedUtils.isTaintedBatch(id, values)), [])
+    assert.deepStrictEqual(Array.from(TaintedUtils.isTaintedBatch(id, values, 1)), [])
+    assert.deepStrictEqual(Array.from(TaintedUtils.isTaintedBatch(id, values, 2)), [0, 1])
+  })
+
+  it('Tainted objects are reported without walking them', function () {
+    const tainted = TaintedUtils.newTaintedObject(id, Buffer.from('test'), 'param', 'REQUEST')
+    assert.deepStrictEqual(Array.from(TaintedUtils.isTaintedBatch(id, [{}, tainted])), [1])
+  })
+
+  it('Cycles and shared references are walked once', function () {
+    const cyclic = { value: 'not tainted' }
+    cyclic.self = cyclic
+    cyclic.again = cyclic
+    assert.deepStrictEqual(Array.from(TaintedUtils.isTaintedBatch(id, [cyclic], 1000)), [])
+
+    const shared = { value: taint('tainted value 1') }
+    assert.deepStrictEqual(Array.from(TaintedUtils.isTaintedBatch(id, [{ shared }, { shared }], 2)), [0, 1])
+    assert.deepStrictEqual(Array.from(TaintedUtils.isTaintedBatch(id, [[{ shared }], { shared }], 2)), [1])
+    assert.deepStrictEqual(Array.from(TaintedUtils.isTaintedBatch(id, [[[shared]], shared], 2)), [1])
+  })
+
+  it('Members with throwing getters are skipped', function () {
+    const values = [taint('tainted value 1'), { get value () { throw new Error('getter') } }, [taint('tainted value 2')]]
+    assert.deepStrictEqual(Array.from(TaintedUtils.isTaintedBatch(id, values, 1)), [0, 2])
+  })
+
+  it('Deep graphs are only walked up to the maximum depth', function () {
+    function chain (length, leaf) {
+      let node = { value: leaf }
+      for (let i = 0; i < length; i++) {
+        node = { next: node }
+      }
+      return node
+    }
+
+    const shallow = chain(30, taint('tainted value 1'))
+    const deep = chain(100000, taint('tainted value 2'))
+    assert.deepStrictEqual(Array.from(TaintedUtils.isTaintedBatch(id, [deep, shallow], 1e9)), [1])
+  })
+
+  it('Nothing tainted returns the size of the bitmap without walking', function () {
+    let calls = 0
+    const values = [{ get value () { calls++; return 'value' } }, 'b', 'c']
+    const ret = TaintedUtils.isTaintedBatch(id, values, 2, true)
+    assert.deepStrictEqual(Array.from(ret), [0])
+    assert.strictEqual(calls, 0)
+  })
+})
@@ -35,7 +35,8 @@ describe('Metrics', function () {
 
   it('Should return the proper request count', function () {
     const expected = {
-      requestCount: 1
+      requestCount: 1,
+      droppedTaints: 0
     }
 
     TaintedUtils.newTaintedString(id, 'a', 'param', 'request')
@@ -49,11 +50,103 @@ describe('Metrics', function () {
 
   it('Should return the properties in all verbosity levels', function () {
     const expected = {
-      requestCount: 1
+      requestCount: 1,
+      droppedTaints: 0
     }
 
     TaintedUtils.newTaintedString(id, 'a', 'param', 'request')
     assert.deepEqual(expected, TaintedUtils.getMetrics(id, Verbosity.INFORMATION), 'Metrics expected to be equal')
-    assert.deepEqual(expected, TaintedUtils.getMetrics(id, Verbosity.DEBUG), 'Metrics expected to be equal')
+
+    const { taintFilter, ...debugMetrics } = TaintedUtils.getMetrics(id, Verbosity.DEBUG)
+    assert.deepEqual(expected, debugMetrics, 'Metrics expected to be equal')
+    assert.ok(taintFilter, 'Filter stats expected in debug')
+  })
+
+  describe('Taint filter', function () {
+    function filterStats () {
+      return TaintedUtils.getMetrics(id, Verbosity.DEBUG).taintFilter
+    }
+
+    it('Should count the lookups answered by the filter', function () {
+      const tainted = TaintedUtils.newTaintedString(id, 'tainted', 'param', 'request')
+      const untainted = []
+      for (let i = 0; i < 100; i++) {
+        untainted.push('untainted' + i)
+      }
+
+      const before = filterStats()
+      assert.strictEqual(TaintedUtils.isTainted(id, tainted), true)
+      untainted.forEach(value => assert.strictEqual(TaintedUtils.isTainted(id, value), false))
+
+      const after = filterStats()
+      const negatives = after.negatives - before.negatives
+      assert.strictEqual(after.positives - before.positives, 1)
+      assert.strictEqual(negatives + after.falsePositives - before.falsePositives, untainted.length)
+      assert.ok(negatives > untainted.length / 2)
+      assert.ok(after.sizeBytes > 0)
+    })
+
+    it('Should find every tainted value once the map grows', function () {
+      const tainted = []
+      for (let i = 0; i < 1000; i++) {
+        tainted.push(TaintedUtils.newTaintedString(id, 'value' + i, 'param', 'request'))
+      }
+      const before = filterStats()
+      assert.strictEqual(tainted.every(value => TaintedUtils.isTainted(id, value)), true)
+
+      const after = filterStats()
+      assert.strictEqual(after.positives - before.positives, tainted.length)
+      assert.ok(after.sizeBytes >= tainted.length * 2)
+    })
+
+    it('Should restart the counters with the transaction', function () {
+      TaintedUtils.newTaintedString(id, 'a', 'param', 'request')
+      TaintedUtils.isTainted(id, 'b')
+      assert.ok(filterStats().negatives > 1)
+      TaintedUtils.removeTransaction(id)
+
+      TaintedUtils.newTaintedString(id, 'a', 'param', 'request')
+      const { negatives, positives, falsePositives } = filterStats()
+      assert.strictEqual(negatives + positives + falsePositives, 1)
+    })
+  })
+
+  describe('Tainted objects limit', function () {
+    afterEach(function () {
+      TaintedUtils.setMaxTaintedObjects(4096)
+    })
+
+    it('Should count the taints dropped over the limit', function () {
+      TaintedUtils.setMaxTaintedObjects(2)
+
+      const tainted = ['a', 'b', 'c'].map(value => TaintedUtils.newTaintedString(id, value, 'param', 'request'))
+      assert.strictEqual(TaintedUtils.isTainted(id, tainted[1]), true)
+      assert.strictEqual(TaintedUtils.isTainted(id, tainted[2]), false)
+      assert.deepEqual({ requestCount: 2, droppedTaints: 1 }, TaintedUtils.getMetrics(id, Verbosity.INFORMATION))
+    })
+
+    it('Should release the entry of a value tainted again', function () {
+      TaintedUtils.setMaxTaintedObjects(3)
+
+      const tainted = ['a', 'b'].map(value => TaintedUtils.newTaintedString(id, value, 'param', 'request'))
+      for (let i = 0; i < 10; i++) {
+        // a + '' is a itself, its entry is replaced by one sharing its ranges
+        assert.strictEqual(TaintedUtils.concat(id, tainted[0], tainted[0], ''), tainted[0])
+      }
+      assert.strictEqual(TaintedUtils.isTainted(id, tainted[0]), true)
+      assert.deepEqual({ requestCount: 2, droppedTaints: 0 }, TaintedUtils.getMetrics(id, Verbosity.INFORMATION))
+    })
+
+    it('Should grow beyond the default limit when it is raised', function () {
+      const count = 5000
+      TaintedUtils.setMaxTaintedObjects(count)
+
+      const tainted = []
+      for (let i = 0; i < count; i++) {
+        tainted.push(TaintedUtils.newTaintedString(id, 'value' + i, 'param', 'request'))
+      }
+      assert.strictEqual(tainted.every(value => TaintedUtils.isTainted(id, value)), true)
+      assert.deepEqual({ requestCount: count, droppedTaints: 0 }, TaintedUtils.getMetrics(id, Verbosity.INFORMATION))
+    })
   })
 })
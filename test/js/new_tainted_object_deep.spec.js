@@ -0,0 +1,95 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+const { TaintedUtils } = require('./util')
+const assert = require('assert')
+
+describe('Taint object graphs', function () {
+  const id = TaintedUtils.createTransaction('1')
+
+  afterEach(function () {
+    TaintedUtils.removeTransaction(id)
+  })
+
+  function parameterName (value) {
+    return TaintedUtils.getRanges(id, value)[0].iinfo.parameterName
+  }
+
+  it('Wrong number of arguments', function () {
+    assert.throws(() => TaintedUtils.newTaintedObjectDeep(id, {}), TypeError)
+  })
+
+  it('Invalid transaction or object taints nothing', function () {
+    const body = { name: 'a long enough value' }
+    assert.strictEqual(TaintedUtils.newTaintedObjectDeep(undefined, body, 'BODY'), 0)
+    assert.strictEqual(TaintedUtils.newTaintedObjectDeep(id, 'not an object', 'BODY'), 0)
+    assert.strictEqual(TaintedUtils.isTainted(id, body.name), false)
+  })
+
+  it('Taints string leaves with their property path', function () {
+    const body = JSON.parse('{"name":"a long enough value","nested":{"list":["first value of list","x"]},"n":1}')
+    const ret = TaintedUtils.newTaintedObjectDeep(id, body, 'BODY')
+    assert.strictEqual(ret, 3)
+
+    assert.strictEqual(TaintedUtils.isTainted(id, body.name), true)
+    assert.strictEqual(parameterName(body.name), 'name')
+    assert.strictEqual(parameterName(body.nested.list[0]), 'nested.list.0')
+    assert.strictEqual(parameterName(body.nested.list[1]), 'nested.list.1')
+
+    const iinfo = TaintedUtils.getRanges(id, body.name)[0].iinfo
+    assert.strictEqual(iinfo.type, 'BODY')
+    assert.strictEqual(iinfo.parameterValue, body.name)
+  })
+
+  it('Short strings are replaced by new tainted strings', function () {
+    const body = { a: 'short' }
+    TaintedUtils.newTaintedObjectDeep(id, body, 'BODY')
+    assert.strictEqual(body.a, 'short')
+    assert.strictEqual(TaintedUtils.isTainted(id, body.a), true)
+    assert.strictEqual(TaintedUtils.isTainted(id, 'short'), false)
+  })
+
+  it('Frozen objects keep their short strings untainted', function () {
+    const body = Object.freeze({ a: 'short', b: 'a long enough value' })
+    assert.strictEqual(TaintedUtils.newTaintedObjectDeep(id, body, 'BODY'), 1)
+    assert.strictEqual(TaintedUtils.isTainted(id, body.a), false)
+    assert.strictEqual(TaintedUtils.isTainted(id, body.b), true)
+  })
+
+  it('Walks up to maxDepth levels', function () {
+    const body = { a: 'first long value', b: { c: 'second long value', d: { e: 'third long value' } } }
+    assert.strictEqual(TaintedUtils.newTaintedObjectDeep(id, body, 'BODY', 2), 2)
+    assert.strictEqual(TaintedUtils.isTainted(id, body.b.c), true)
+    assert.strictEqual(TaintedUtils.isTainted(id, body.b.d.e), false)
+  })
+
+  it('Stops after maxLeaves leaves', function () {
+    const body = { a: 'first long value', b: 'second long value', c: 'third long value' }
+    assert.strictEqual(TaintedUtils.newTaintedObjectDeep(id, body, 'BODY', 10, 2), 2)
+    assert.strictEqual(TaintedUtils.isTainted(id, body.c), false)
+  })
+
+  it('Already tainted leaves are not counted', function () {
+    const body = { a: TaintedUtils.newTaintedString(id, 'first long value', 'a', 'QUERY'), b: 'second long value' }
+    assert.strictEqual(TaintedUtils.newTaintedObjectDeep(id, body, 'BODY'), 1)
+    assert.strictEqual(TaintedUtils.getRanges(id, body.a)[0].iinfo.type, 'QUERY')
+  })
+
+  it('Tainting the same object again keeps its members', function () {
+    const body = { a: 'short', b: 'a long enough value', c: { d: 'x' } }
+    assert.strictEqual(TaintedUtils.newTaintedObjectDeep(id, body, 'BODY'), 3)
+    const count = TaintedUtils.getMetrics(id, 2).requestCount
+
+    assert.strictEqual(TaintedUtils.newTaintedObjectDeep(id, body, 'BODY'), 0)
+    assert.strictEqual(TaintedUtils.getMetrics(id, 2).requestCount, count)
+    assert.strictEqual(TaintedUtils.isTainted(id, body.a), true)
+    assert.strictEqual(parameterName(body.c.d), 'c.d')
+  })
+
+  it('Cyclic objects are walked once', function () {
+    const body = { a: 'first long value' }
+    body.self = body
+    assert.strictEqual(TaintedUtils.newTaintedObjectDeep(id, body, 'BODY', 1000), 1)
+  })
+})
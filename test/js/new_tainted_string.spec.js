@@ -168,6 +168,72 @@ describe('Taint strings', function () {
     assert.strictEqual(false, TaintedUtils.isTainted(id, oneChar), 'Can not be tainted')
   })
 
+  describe('Input infos', function () {
+    function iinfo (taintedValue) {
+      return TaintedUtils.getRanges(id, taintedValue)[0].iinfo
+    }
+
+    it('Same source shares its input info', function () {
+      const first = TaintedUtils.newTaintedString(id, value, 'param', 'REQUEST')
+      const second = TaintedUtils.newTaintedString(id, value, 'param', 'REQUEST')
+      assert.notStrictEqual(TaintedUtils.getRanges(id, first), TaintedUtils.getRanges(id, second))
+      assert.strictEqual(iinfo(first), iinfo(second))
+    })
+
+    it('Different sources do not share their input info', function () {
+      const tainted = TaintedUtils.newTaintedString(id, value, 'param', 'REQUEST')
+      const otherName = TaintedUtils.newTaintedString(id, value, 'param2', 'REQUEST')
+      const otherType = TaintedUtils.newTaintedString(id, value, 'param', 'HEADER')
+      const otherValue = TaintedUtils.newTaintedString(id, 'test2', 'param', 'REQUEST')
+
+      assert.notStrictEqual(iinfo(tainted), iinfo(otherName))
+      assert.notStrictEqual(iinfo(tainted), iinfo(otherType))
+      assert.notStrictEqual(iinfo(tainted), iinfo(otherValue))
+      assert.deepStrictEqual(iinfo(otherValue), { parameterName: 'param', parameterValue: 'test2', type: 'REQUEST' })
+    })
+
+    it('Keeps non ASCII names and types', function () {
+      const tainted = TaintedUtils.newTaintedString(id, value, 'paràm 佫', 'tipo ü')
+      assert.deepStrictEqual(iinfo(tainted), { parameterName: 'paràm 佫', parameterValue: value, type: 'tipo ü' })
+    })
+
+    it('Keeps names and types that are not strings', function () {
+      const tainted = TaintedUtils.newTaintedString(id, value, 1, undefined)
+      assert.deepStrictEqual(iinfo(tainted), { parameterName: 1, parameterValue: value, type: undefined })
+    })
+
+    it('Keeps long names and tells apart names that only differ at the end', function () {
+      const longName = 'p'.repeat(5000)
+      const names = [longName, longName.slice(1) + 'q', 'n'.repeat(100) + 'a', 'n'.repeat(100) + 'b']
+      const tainted = names.map(name => TaintedUtils.newTaintedString(id, value, name, 'REQUEST'))
+      tainted.forEach((taintedValue, i) => assert.strictEqual(iinfo(taintedValue).parameterName, names[i]))
+
+      const again = TaintedUtils.newTaintedString(id, value, 'n'.repeat(100) + 'b', 'REQUEST')
+      assert.strictEqual(iinfo(again), iinfo(tainted[3]))
+    })
+
+    it('Keeps types beyond the interned ones', function () {
+      const tainted = []
+      for (let i = 0; i < 100; i++) {
+        tainted.push(TaintedUtils.newTaintedString(id, value, 'param', `type${i}`))
+      }
+      tainted.forEach((taintedValue, i) => assert.strictEqual(iinfo(taintedValue).type, `type${i}`))
+    })
+  })
+
+  describe('Taint short strings', function () {
+    const shortStrings = ['ab', 'abc佫', 'ü😂', '\uD83Dx', '123456789']
+
+    shortStrings.forEach((testStr) => {
+      it(`Taint ${testStr}`, function () {
+        const taintedStr = TaintedUtils.newTaintedString(id, testStr, 'param', 'request')
+        assert.strictEqual(true, TaintedUtils.isTainted(id, taintedStr), 'Must be tainted')
+        assert.strictEqual(false, TaintedUtils.isTainted(id, testStr), 'Original must not be tainted')
+        assert.strictEqual(testStr, taintedStr, 'Strings must be equal')
+      })
+    })
+  })
+
   describe('Taint special one char strings', function () {
     const specialOneCharStrings = ['佫', 'ü', 'ô', 'é', 'à']
 
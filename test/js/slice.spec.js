@@ -100,22 +100,32 @@ describe('Slice', function () {
     },
     {
       source: 'foo:+-bar-+:b:+-a-+:z:+-z-+::+-z-+:',
+      distinctSources: true,
       result: 'b:+-a-+:z',
       start: 6,
       end: 9
     },
     {
       source: 'foo:+-bar-+:b:+-a-+:z:+-z-+::+-z-+:',
+      distinctSources: true,
       result: 'b:+-a-+:z:+-z-+:',
       start: 6,
       end: 10
     },
     {
       source: 'foo:+-bar-+:b:+-a-+:z:+-z-+::+-z-+:',
+      distinctSources: true,
       result: 'b:+-a-+:z:+-z-+::+-z-+:',
       start: 6,
       end: 20
     },
+    {
+      // adjacent ranges from the same source are coalesced
+      source: 'foo:+-bar-+:b:+-a-+:z:+-z-+::+-z-+:',
+      result: 'b:+-a-+:z:+-zz-+:',
+      start: 6,
+      end: 20
+    },
     {
       source: ':+-bar-+:foo:+-baz-+:',
       result: ':+-bar-+:foo:+-b-+:',
@@ -183,9 +193,9 @@ describe('Slice', function () {
   })
 
   describe('Range test cases', function () {
-    testCases.forEach(({ source, result, start, end }) => {
+    testCases.forEach(({ source, result, start, end, distinctSources }) => {
       it(`Test ${source}`, () => {
-        const string = taintFormattedString(id, source)
+        const string = taintFormattedString(id, source, distinctSources)
         assert.equal(TaintedUtils.isTainted(id, string), true, 'String not tainted')
         let res, ret
         if (typeof end === 'undefined') {
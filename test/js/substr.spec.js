@@ -109,30 +109,42 @@ const rangesTestCases = [
   },
   {
     source: 'foo:+-bar-+:b:+-a-+:z:+-z-+::+-z-+:',
+    distinctSources: true,
     result: 'b:+-a-+:z:+-z-+::+-z-+:',
     start: 6,
     end: 9
   },
   {
     source: 'foo:+-bar-+:b:+-a-+:z:+-z-+::+-z-+:',
+    distinctSources: true,
     result: 'b:+-a-+:z:+-z-+::+-z-+:',
     start: 6,
     end: 10
   },
   {
     source: 'foo:+-bar-+:b:+-a-+:z:+-z-+::+-z-+:',
+    distinctSources: true,
     result: 'b:+-a-+:z:+-z-+::+-z-+:',
     start: 6,
     end: 20
   },
   {
+    // adjacent ranges from the same source are coalesced
     source: 'foo:+-bar-+:b:+-a-+:z:+-z-+::+-z-+:',
+    result: 'b:+-a-+:z:+-zz-+:',
+    start: 6,
+    end: 20
+  },
+  {
+    source: 'foo:+-bar-+:b:+-a-+:z:+-z-+::+-z-+:',
+    distinctSources: true,
     result: 'b:+-a-+:z:+-z-+::+-z-+:',
     start: 6,
     end: undefined
   },
   {
     source: 'foo:+-bar-+:b:+-a-+:z:+-z-+::+-z-+:',
+    distinctSources: true,
     result: 'b:+-a-+:z:+-z-+::+-z-+:',
     start: 6
   },
@@ -294,10 +306,10 @@ describe('Check Ranges format', function () {
   })
 
   rangesTestCases.forEach((testData) => {
-    const { source, start, end, result } = testData
+    const { source, start, end, result, distinctSources } = testData
 
     it(`Test ${source}`, function () {
-      const inputString = taintFormattedString(id, source)
+      const inputString = taintFormattedString(id, source, distinctSources)
       assert.equal(TaintedUtils.isTainted(id, inputString), true, 'Not tainted')
       const res = inputString.substr(start, end)
 
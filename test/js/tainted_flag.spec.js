@@ -0,0 +1,69 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+
+'use strict'
+
+const { TaintedUtils, formatTaintedValue } = require('./util')
+const assert = require('assert')
+const v8 = require('v8')
+const vm = require('vm')
+
+v8.setFlagsFromString('--expose-gc')
+const gc = vm.runInNewContext('gc')
+
+describe('Tainted flag', function () {
+  const id = TaintedUtils.createTransaction('1')
+  const otherId = TaintedUtils.createTransaction('2')
+  const { taintedFlag } = TaintedUtils
+
+  afterEach(function () {
+    TaintedUtils.removeTransaction(id)
+    TaintedUtils.removeTransaction(otherId)
+  })
+
+  it('Should be set while a value is tainted', function () {
+    TaintedUtils.removeTransaction(id)
+    const before = taintedFlag[0]
+
+    TaintedUtils.newTaintedString(id, 'tainted', 'param', 'request')
+    assert.strictEqual(taintedFlag[0], 1)
+
+    TaintedUtils.removeTransaction(id)
+    assert.strictEqual(taintedFlag[0], before)
+  })
+
+  it('Should stay set until the values of every transaction are gone', function () {
+    const before = taintedFlag[0]
+    TaintedUtils.newTaintedString(id, 'tainted', 'param', 'request')
+    TaintedUtils.newTaintedString(otherId, 'tainted', 'param', 'request')
+
+    TaintedUtils.removeTransaction(id)
+    assert.strictEqual(taintedFlag[0], 1)
+
+    TaintedUtils.removeTransaction(otherId)
+    assert.strictEqual(taintedFlag[0], before)
+  })
+
+  it('Should stay set across GCs', function () {
+    const tainted = TaintedUtils.newTaintedString(id, 'tainted', 'param', 'request')
+
+    gc({ type: 'minor' })
+    gc()
+    assert.strictEqual(taintedFlag[0], 1)
+    assert.strictEqual(TaintedUtils.isTainted(id, tainted), true)
+  })
+
+  it('Should not propagate through a transaction without tainted values', function () {
+    TaintedUtils.newTaintedString(otherId, 'other', 'param', 'request')
+    const value = 'a' + 'b'
+    const ret = TaintedUtils.concat(id, value, 'a', 'b')
+    assert.strictEqual(ret, value)
+    assert.strictEqual(TaintedUtils.isTainted(id, ret), false)
+
+    const tainted = TaintedUtils.newTaintedString(id, 'tainted', 'param', 'request')
+    const concat = TaintedUtils.concat(id, 'a' + tainted, 'a', tainted)
+    assert.strictEqual(formatTaintedValue(id, concat), 'a:+-tainted-+:')
+  })
+})
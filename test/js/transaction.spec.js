@@ -88,4 +88,72 @@ describe('Transaction', function () {
     TaintedUtils.removeTransaction(id)
     TaintedUtils.removeTransaction(id)
   })
+
+  describe('Handles', function () {
+    beforeEach(function () {
+      TaintedUtils.setMaxTransactions(2)
+    })
+
+    it('Propagate taint using a transaction handle', function () {
+      const handle = TaintedUtils.createTransaction('1', true)
+      assert.strictEqual(typeof handle, 'object')
+
+      const value = TaintedUtils.newTaintedString(handle, 'value', 'param', 'REQUEST')
+      assert.strictEqual(true, TaintedUtils.isTainted(handle, value))
+
+      const result = TaintedUtils.concat(handle, value + 'suffix', value, 'suffix')
+      assert.strictEqual(true, TaintedUtils.isTainted(handle, result))
+      assert.strictEqual(1, TaintedUtils.getRanges(handle, result).length)
+      assert.strictEqual(2, TaintedUtils.getMetrics(handle, 2).requestCount)
+
+      TaintedUtils.removeTransaction(handle)
+    })
+
+    it('Keep handle and string transactions apart', function () {
+      const handle = TaintedUtils.createTransaction('1', true)
+      const id = TaintedUtils.createTransaction('1')
+
+      const value = TaintedUtils.newTaintedString(handle, 'value', 'param', 'REQUEST')
+      assert.strictEqual(false, TaintedUtils.isTainted(id, value))
+
+      TaintedUtils.removeTransaction(handle)
+    })
+
+    it('Invalidate handle when the transaction is removed', function () {
+      const handle = TaintedUtils.createTransaction('1', true)
+      const value = TaintedUtils.newTaintedString(handle, 'value', 'param', 'REQUEST')
+      TaintedUtils.removeTransaction(handle)
+
+      assert.strictEqual(false, TaintedUtils.isTainted(handle, value))
+      assert.strictEqual(null, TaintedUtils.getMetrics(handle, 2))
+
+      // the removed transaction is reused for another id
+      const id = TaintedUtils.createTransaction('2')
+      const value2 = TaintedUtils.newTaintedString(id, 'value2', 'param', 'REQUEST')
+      assert.strictEqual(false, TaintedUtils.isTainted(handle, value2))
+      assert.strictEqual(true, TaintedUtils.isTainted(id, value2))
+
+      TaintedUtils.removeTransaction(id)
+      TaintedUtils.removeTransaction(handle)
+    })
+
+    it('Ignore objects that are not handles', function () {
+      const value = TaintedUtils.newTaintedString({}, 'value', 'param', 'REQUEST')
+      assert.strictEqual(false, TaintedUtils.isTainted({}, value))
+    })
+
+    it('Ignore native objects with internal fields', function () {
+      const handle = TaintedUtils.createTransaction('1', true)
+      TaintedUtils.newTaintedString(handle, 'tainted', 'param', 'REQUEST')
+
+      // node wraps its native objects in objects with internal fields
+      const natives = [require('zlib').createDeflate()._handle, new (require('util').TextDecoder)()]
+      natives.forEach(native => {
+        const value = TaintedUtils.newTaintedString(native, 'value', 'param', 'REQUEST')
+        assert.strictEqual(false, TaintedUtils.isTainted(native, value))
+        assert.strictEqual(null, TaintedUtils.getMetrics(native, 2))
+      })
+      TaintedUtils.removeTransaction(handle)
+    })
+  })
 })
@@ -248,6 +248,12 @@ describe('Trim operator', function () {
       trimResult: ':+-佫-+: :+-😂😂😂-+: :+-𝒳-+:',
       trimStartResult: ':+-佫-+: :+-😂😂😂-+: :+-𝒳  -+: ',
       trimEndResult: ' :+-  佫-+: :+-😂😂😂-+: :+-𝒳-+:'
+    },
+    {
+      testString: '\u00a0\u3000:+-\u2003ABC\u2029-+:\ufeff\n',
+      trimResult: ':+-ABC-+:',
+      trimStartResult: ':+-ABC\u2029-+:\ufeff\n',
+      trimEndResult: '\u00a0\u3000:+-\u2003ABC-+:'
     }
   ]
 
@@ -358,8 +364,15 @@ describe('Trim operator', function () {
   })
 
   describe('trimStart', function () {
+    it('Wrong arguments trimStart', function () {
+      assert.throws(function () {
+        TaintedUtils.trimStart(id)
+      }, Error)
+    })
+
     it('Check result', function () {
       testTrimResult(String.prototype.trimStart, TaintedUtils.trim)
+      testTrimResult(String.prototype.trimStart, TaintedUtils.trimStart)
     })
 
     it('Check result from not tainted value', function () {
@@ -382,6 +395,7 @@ describe('Trim operator', function () {
       rangesTestCases.forEach(({ testString, trimStartResult }) => {
         it(`Test ${testString}`, () => {
           testTrimCheckRanges(String.prototype.trimStart, TaintedUtils.trim, testString, trimStartResult)
+          testTrimCheckRanges(String.prototype.trimStart, TaintedUtils.trimStart, testString, trimStartResult)
         })
       })
     })
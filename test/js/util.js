@@ -11,7 +11,10 @@ const RANGE_CLOSING_MARK = '-+:'
 const PARAM_NAME = 'param'
 const PARAM_TYPE = 'REQUEST'
 
-function taintFormattedString (transactionId, formattedString) {
+// With distinctSources every tainted part gets its own parameter name, so adjacent parts
+// are kept as separate ranges instead of being coalesced.
+function taintFormattedString (transactionId, formattedString, distinctSources = false) {
+  let sources = 0
   return formattedString && typeof formattedString === 'string'
     ? formattedString.split(RANGE_OPEN_MARK).reduce((previousValue, currentValue) => {
       if (currentValue.length === 0) {
@@ -19,7 +22,8 @@ function taintFormattedString (transactionId, formattedString) {
       }
       if (currentValue.indexOf(RANGE_CLOSING_MARK) > -1) {
         const splitParts = currentValue.split(RANGE_CLOSING_MARK)
-        const tainted = TaintedUtils.newTaintedString(transactionId, splitParts[0], PARAM_NAME, PARAM_TYPE)
+        const tainted = TaintedUtils.newTaintedString(transactionId, splitParts[0],
+          distinctSources ? `${PARAM_NAME}${sources++}` : PARAM_NAME, PARAM_TYPE)
         const previousPlusTainted = TaintedUtils.concat(transactionId, previousValue + tainted, previousValue, tainted)
         if (splitParts.length === 1) return previousPlusTainted
         const literal = splitParts[1]
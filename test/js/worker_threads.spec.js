@@ -0,0 +1,58 @@
+/**
+* Unless explicitly stated otherwise all files in this repository are licensed under the Apache-2.0 License.
+* This product includes software developed at Datadog (https://www.datadoghq.com/). Copyright 2022 Datadog, Inc.
+**/
+
+'use strict'
+
+const { TaintedUtils } = require('./util')
+const assert = require('assert')
+const path = require('path')
+const { Worker } = require('worker_threads')
+
+const WORKER_CODE = `
+const { parentPort, workerData } = require('worker_threads')
+const TaintedUtils = require(workerData.modulePath)
+
+TaintedUtils.setMaxTransactions(1)
+let tainted = 0
+for (let request = 0; request < workerData.requests; request++) {
+  const id = TaintedUtils.createTransaction(String(request))
+  let value = TaintedUtils.newTaintedString(id, 'value-' + request, 'param', 'request')
+  for (let i = 0; i < 100; i++) {
+    value = TaintedUtils.concat(id, value + i, value, String(i))
+  }
+  if (TaintedUtils.isTainted(id, value) && TaintedUtils.getRanges(id, value).length === 1) {
+    tainted++
+  }
+  TaintedUtils.removeTransaction(id)
+}
+parentPort.postMessage(tainted)
+`
+
+function runWorker (requests) {
+  return new Promise((resolve, reject) => {
+    const worker = new Worker(WORKER_CODE, {
+      eval: true,
+      workerData: { modulePath: path.resolve(__dirname, '../../index'), requests }
+    })
+    worker.on('message', resolve)
+    worker.on('error', reject)
+  })
+}
+
+describe('Worker threads', function () {
+  it('Keep transactions of every thread apart', async function () {
+    const requests = 200
+    const workers = [runWorker(requests), runWorker(requests)]
+
+    const id = TaintedUtils.createTransaction('main')
+    const value = TaintedUtils.newTaintedString(id, 'value', 'param', 'request')
+
+    const results = await Promise.all(workers)
+    results.forEach(tainted => assert.strictEqual(tainted, requests))
+
+    assert.strictEqual(true, TaintedUtils.isTainted(id, value))
+    TaintedUtils.removeTransaction(id)
+  })
+})